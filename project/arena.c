@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+#include "diagnostics.h"
+
+/*The strictest alignment of the types allocated from an arena*/
+typedef union arenaAlignment{
+    long l;
+    double d;
+    void* p;
+}arenaAlignment;
+
+#define ARENA_ALIGNMENT sizeof(arenaAlignment)
+#define ALIGN_SIZE(size) (((size) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT)
+
+/*A block of memory of an arena, the allocations follow the header*/
+typedef struct arenaBlock * arenaBlock_ptr;
+typedef struct arenaBlock{
+
+    /*Pointer to the next block (the blocks that were filled before)*/
+    arenaBlock_ptr next;
+
+    /*The number of bytes after the header*/
+    size_t size;
+
+    /*The number of bytes that were allocated*/
+    size_t used;
+
+}arenaBlock;
+
+#define BLOCK_HEADER_SIZE ALIGN_SIZE(sizeof(arenaBlock))
+
+struct arena{
+
+    /*The block that allocations are carved from, followed by all the other blocks*/
+    arenaBlock_ptr blocks;
+};
+
+arena_ptr createArena(void){
+    arena_ptr arena = (arena_ptr) malloc(sizeof(struct arena));
+    if(arena==NULL){ report("Error: cannot allocate memory\n");return NULL;}
+    arena->blocks = NULL;
+    return arena;
+}
+
+void* arenaAlloc(arena_ptr arena, size_t size){
+    arenaBlock_ptr block = arena->blocks;
+    void* memory;
+
+    size = (size == 0) ? ARENA_ALIGNMENT : ALIGN_SIZE(size);
+    if(block==NULL || block->size - block->used < size){
+        size_t blockSize = (size > ARENA_BLOCK_SIZE) ? size : ARENA_BLOCK_SIZE;
+        block = (arenaBlock_ptr) malloc(BLOCK_HEADER_SIZE + blockSize);
+        if(block==NULL){ report("Error: cannot allocate memory\n");return NULL;}
+        block->size = blockSize;
+        block->used = 0;
+
+        /*A large allocation gets a block of its own behind the current block, so the rest of the current block is still used*/
+        if(blockSize > ARENA_BLOCK_SIZE && arena->blocks!=NULL){
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        }
+        else{
+            block->next = arena->blocks;
+            arena->blocks = block;
+        }
+    }
+
+    memory = (char*)block + BLOCK_HEADER_SIZE + block->used;
+    block->used += size;
+    return memory;
+}
+
+void mergeArenas(arena_ptr arena, arena_ptr other){
+    arenaBlock_ptr last;
+
+    if(other==NULL)return;
+
+    /*The blocks of the other arena are linked behind the current block*/
+    if(other->blocks!=NULL){
+        last = other->blocks;
+        while (last->next!=NULL)
+            last = last->next;
+        if(arena->blocks==NULL)
+            arena->blocks = other->blocks;
+        else{
+            last->next = arena->blocks->next;
+            arena->blocks->next = other->blocks;
+        }
+    }
+    free(other);
+}
+
+void freeArena(arena_ptr arena){
+    arenaBlock_ptr temp;
+
+    /*Frees all the blocks, then the arena itself*/
+    if(arena==NULL)return;
+    while (arena->blocks!=NULL){
+        temp = arena->blocks;
+        arena->blocks = arena->blocks->next;
+        free(temp);
+    }
+    free(arena);
+}
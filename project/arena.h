@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE 65536 /*The size of a block of memory the arena carves its allocations from*/
+
+/*Memory that is allocated piece by piece and freed all at once (its content is private to arena.c)*/
+typedef struct arena * arena_ptr;
+
+/**
+ * Creates a new empty arena.
+ *
+ * @return A pointer to the new arena, or NULL if memory could not be allocated.
+ */
+arena_ptr createArena(void);
+
+/**
+ * Allocates memory from an arena, the memory is aligned for any type and is not initialized.
+ * A block of ARENA_BLOCK_SIZE bytes is added to the arena when the current one is full.
+ *
+ * @param arena The arena to allocate from.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the memory, or NULL if memory could not be allocated.
+ */
+void* arenaAlloc(arena_ptr arena, size_t size);
+
+/**
+ * Moves all the memory of an arena into another arena (and frees the first one),
+ * what was allocated from it stays valid until the other arena is freed.
+ *
+ * @param arena The arena that gets the memory.
+ * @param other The arena whose memory is moved.
+ */
+void mergeArenas(arena_ptr arena, arena_ptr other);
+
+/**
+ * Frees an arena and all the memory that was allocated from it.
+ *
+ * @param arena The arena to free (may be NULL).
+ */
+void freeArena(arena_ptr arena);
+
+#endif /* ARENA_H */
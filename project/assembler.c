@@ -1,11 +1,39 @@
-#include <stdio.h>
-#include "decode.h"
-
-int main(int argc, char *argv[]) {
-    int i;
-    if (argc < 2)
-        printf("No file names provided.\n");
-    for (i = 1; i < argc; i++)
-        decodeFile(argv[i]);
-    return 1;
-}
\ No newline at end of file
+#include <stdio.h>
+#include <stdlib.h>
+#include "decode.h"
+#include "commandLine.h"
+#include "fileList.h"
+#include "serve.h"
+#include "globals.h"
+
+int main(int argc, char *argv[]) {
+    fileList_ptr argList, files;
+    options opts;
+
+    initOptions(&opts);
+    argList = expandArguments(argc, argv);
+    files = createFileList();
+    if (argList == NULL || files == NULL) {
+        freeFileList(argList);
+        freeFileList(files);
+        return 1;
+    }
+
+    /*Reads the options first, so they apply to every file*/
+    parseArguments(argList->names, argList->count, &opts, files);
+
+    /*A server assembles the files of its clients instead*/
+    if (opts.serveSocket != NULL) {
+        runServer(opts.serveSocket, &opts);
+        freeFileList(files);
+        freeFileList(argList);
+        return 1;
+    }
+
+    if (files->count == 0)
+        printf("No file names provided.\n");
+    decodeFiles(files->names, files->count, &opts);
+    freeFileList(files);
+    freeFileList(argList);
+    return 1;
+}
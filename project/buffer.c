@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <string.h>
+#include "buffer.h"
+#include "globals.h"
+
+buffer_ptr createBuffer(void){
+
+    /*Creates an empty buffer with a small initial capacity*/
+    buffer_ptr buffer = (buffer_ptr) malloc(sizeof(textBuffer));
+    if(buffer==NULL)
+        return NULL;
+    buffer->text = (char*) malloc(BUFFER_INITIAL_SIZE);
+    if(buffer->text==NULL){
+        free(buffer);
+        return NULL;
+    }
+    buffer->text[0] = NULL_TERM;
+    buffer->length = 0;
+    buffer->size = BUFFER_INITIAL_SIZE;
+    return buffer;
+}
+
+int reserveBuffer(buffer_ptr buffer, long length){
+
+    /*Doubles the capacity until the new text fits (including the null terminator)*/
+    if(buffer->length + length + 1 > buffer->size){
+        long newSize = buffer->size;
+        char* newText;
+        while (buffer->length + length + 1 > newSize)
+            newSize *= 2;
+        newText = (char*) realloc(buffer->text, newSize);
+        if(newText==NULL)
+            return FALSE;
+        buffer->text = newText;
+        buffer->size = newSize;
+    }
+    return TRUE;
+}
+
+int appendToBuffer(buffer_ptr buffer, const char* text, long length){
+    if(reserveBuffer(buffer, length)==FALSE)
+        return FALSE;
+
+    /*Copies the text to the end of the buffer*/
+    memcpy(buffer->text + buffer->length, text, length);
+    buffer->length += length;
+    buffer->text[buffer->length] = NULL_TERM;
+    return TRUE;
+}
+
+int appendStringToBuffer(buffer_ptr buffer, const char* str){
+    return appendToBuffer(buffer, str, (long)strlen(str));
+}
+
+int readLineFromBuffer(buffer_ptr buffer, long* position, char* line, int maxLength){
+    long remaining = buffer->length - (*position);
+    long length = (remaining < maxLength - 1) ? remaining : maxLength - 1;
+    const char* start = buffer->text + (*position);
+    const char* endOfLine;
+
+    /*No more lines in the buffer*/
+    if(remaining <= 0)
+        return FALSE;
+
+    /*The line ends after the '\n' character, or when the line array is full*/
+    endOfLine = (const char*) memchr(start, END_OF_LINE, length);
+    if(endOfLine != NULL)
+        length = endOfLine - start + 1;
+
+    memcpy(line, start, length);
+    line[length] = NULL_TERM;
+    (*position) += length;
+    return TRUE;
+}
+
+void freeBuffer(buffer_ptr buffer){
+
+    /*Frees the text and the buffer itself*/
+    if(buffer==NULL)return;
+    free(buffer->text);
+    free(buffer);
+}
@@ -0,0 +1,74 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#define BUFFER_INITIAL_SIZE 256 /*The initial capacity of a text buffer*/
+
+/*A growable block of text held in memory*/
+typedef struct textBuffer * buffer_ptr;
+typedef struct textBuffer{
+
+    /*The text itself (always null terminated)*/
+    char* text;
+
+    /*The number of characters in the buffer (without the null terminator)*/
+    long length;
+
+    /*The number of bytes allocated for the text*/
+    long size;
+
+}textBuffer;
+
+/**
+ * Creates a new empty text buffer.
+ *
+ * @return A pointer to the new buffer, or NULL if memory could not be allocated.
+ */
+buffer_ptr createBuffer(void);
+
+/**
+ * Makes room for more characters at the end of a text buffer (to read into it directly).
+ *
+ * @param buffer The buffer.
+ * @param length The number of characters to make room for (after the null terminator is kept).
+ * @return 0 if there is room, -1 if memory could not be allocated.
+ */
+int reserveBuffer(buffer_ptr buffer, long length);
+
+/**
+ * Appends characters to the end of a text buffer, growing it if needed.
+ *
+ * @param buffer The buffer to append to.
+ * @param text The characters to append.
+ * @param length The number of characters to append.
+ * @return 0 if the characters were appended, -1 if memory could not be allocated.
+ */
+int appendToBuffer(buffer_ptr buffer, const char* text, long length);
+
+/**
+ * Appends a null terminated string to the end of a text buffer.
+ *
+ * @param buffer The buffer to append to.
+ * @param str The string to append.
+ * @return 0 if the string was appended, -1 if memory could not be allocated.
+ */
+int appendStringToBuffer(buffer_ptr buffer, const char* str);
+
+/**
+ * Reads the next line from a text buffer, the same way fgets reads a line from a file.
+ *
+ * @param buffer The buffer to read from.
+ * @param position A pointer to the position in the buffer, advanced past the line that was read.
+ * @param line The array to store the line in (including the '\n' if it fits).
+ * @param maxLength The size of the line array.
+ * @return 0 if a line was read, -1 if the end of the buffer was reached.
+ */
+int readLineFromBuffer(buffer_ptr buffer, long* position, char* line, int maxLength);
+
+/**
+ * Frees the memory allocated for a text buffer.
+ *
+ * @param buffer The buffer to free.
+ */
+void freeBuffer(buffer_ptr buffer);
+
+#endif /* BUFFER_H */
@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "commandLine.h"
+#include "fileList.h"
+#include "protocol.h"
+#include "globals.h"
+
+/*The client of the assembler server (started with --serve). It takes the same arguments as the assembler,
+ *sends them to the server with the directory they are relative to, and prints the messages the server sends back,
+ *so it can be used in place of the assembler. The socket of the server is given with --socket PATH,
+ *or in the environment variable PROTOCOL_SOCKET_ENV.*/
+
+#define CWD_INITIAL_SIZE 256 /*The initial size of the name of the current directory*/
+
+/**
+ * Gets the name of the current directory.
+ *
+ * @return A new string with the name, or NULL if it cannot be found.
+ */
+static char* currentDirectory(void);
+
+/**
+ * Connects to the server.
+ *
+ * @param socketPath The path of the socket of the server.
+ * @return The socket of the connection, or -1 if it cannot connect.
+ */
+static int connectToServer(const char* socketPath);
+
+/**
+ * Prints the messages of a reply of the server.
+ *
+ * @param reply The text of the reply.
+ * @return 0 if the server did the request, -1 if the reply ended before it was done.
+ */
+static int printReply(buffer_ptr reply);
+
+int main(int argc, char *argv[]) {
+    fileList_ptr argList, lists;
+    buffer_ptr req, reply = NULL;
+    char* socketPath = getenv(PROTOCOL_SOCKET_ENV);
+    char* cwd = currentDirectory();
+    char** args;
+    int i, j, numOfArgs, fd;
+
+    argList = expandArguments(argc, argv);
+    lists = createFileList();
+    req = createBuffer();
+    if (argList == NULL || lists == NULL || req == NULL) {
+        freeFileList(argList);
+        freeFileList(lists);
+        freeBuffer(req);
+        free(cwd);
+        return 1;
+    }
+    args = argList->names;
+    numOfArgs = argList->count;
+
+    /*The arguments are sent as they are, but the lists of files are read here (they may be the standard input)*/
+    if (cwd != NULL)
+        appendMessage(req, PROTOCOL_CWD, cwd, NULL, 0);
+    for (i = 0; i < numOfArgs; i++) {
+        if (strcmp(args[i], "--socket") == 0) {
+            if (i + 1 >= numOfArgs)
+                printf("Error: --socket needs the path of the socket of the server\n");
+            else
+                socketPath = args[i + 1];
+            if (i + 1 < numOfArgs)
+                i++;
+        }
+        else if (strcmp(args[i], "--files-from") == 0) {
+            int first = lists->count;
+            if (i + 1 >= numOfArgs)
+                printf("Error: --files-from needs a file with a file name in every line (- for the standard input)\n");
+            else
+                addFromListFile(lists, args[i + 1], TRUE);
+            for (j = first; j < lists->count; j++)
+                appendMessage(req, PROTOCOL_ARG, lists->names[j], NULL, 0);
+            if (i + 1 < numOfArgs)
+                i++;
+        }
+        else
+            appendMessage(req, PROTOCOL_ARG, args[i], NULL, 0);
+    }
+
+    if (socketPath == NULL)
+        printf("Error: no server socket, give --socket PATH or set %s\n", PROTOCOL_SOCKET_ENV);
+    else if ((fd = connectToServer(socketPath)) < 0)
+        printf("Error: cannot connect to the assembler server at %s\n", socketPath);
+    else {
+
+        /*The server reads the request until this side of the connection is shut down*/
+        if (sendText(fd, req->text, req->length) == TRUE && shutdown(fd, SHUT_WR) == 0)
+            reply = receiveText(fd, 0);
+        close(fd);
+        if (reply == NULL || printReply(reply) == FALSE)
+            printf("Error: the assembler server did not finish the request\n");
+    }
+
+    freeBuffer(reply);
+    freeBuffer(req);
+    freeFileList(lists);
+    freeFileList(argList);
+    free(cwd);
+    return 1;
+}
+
+static char* currentDirectory(void){
+    size_t size = CWD_INITIAL_SIZE;
+    char* cwd = NULL;
+
+    /*Doubles the name until it fits*/
+    while (1) {
+        char* newCwd = (char*) realloc(cwd, size);
+        if(newCwd==NULL){
+            free(cwd);
+            printf("cannot allocate memory");
+            return NULL;
+        }
+        cwd = newCwd;
+        if(getcwd(cwd, size) != NULL)
+            return cwd;
+        if(errno != ERANGE){
+            free(cwd);
+            return NULL;
+        }
+        size *= 2;
+    }
+}
+
+static int connectToServer(const char* socketPath){
+    struct sockaddr_un address;
+    int fd;
+
+    if(strlen(socketPath) >= sizeof(address.sun_path))
+        return -1;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0)
+        return -1;
+    if(connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0){
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int printReply(buffer_ptr reply){
+    message msg;
+    long position = 0;
+
+    while (readMessage(reply, &position, &msg) == TRUE) {
+        if(strcmp(msg.name, PROTOCOL_DIAGNOSTICS) == 0)
+            fwrite(msg.data, 1, msg.length, stdout);
+        else if(strcmp(msg.name, PROTOCOL_DONE) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
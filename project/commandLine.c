@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "commandLine.h"
+#include "diagnostics.h"
+#include "threadPool.h"
+#include "globals.h"
+
+void initOptions(options_ptr opts){
+    opts->keepAm = FALSE;
+    opts->lexThreads = 1;
+    opts->jobs = 1;
+    opts->pipeline = FALSE;
+    opts->writeObj = FALSE;
+    opts->writeImage = FALSE;
+    opts->writeHex = FALSE;
+    opts->serveSocket = NULL;
+}
+
+fileList_ptr expandArguments(int argc, char** argv){
+    fileList_ptr argList = createFileList();
+    int i;
+
+    if(argList==NULL)
+        return NULL;
+
+    /*A response file (@file) is replaced by the arguments in it*/
+    for (i = 1; i < argc; i++) {
+        if (argv[i][0] == RESPONSE_FILE)
+            addFromListFile(argList, argv[i] + 1, FALSE);
+        else
+            addToFileList(argList, argv[i]);
+    }
+    return argList;
+}
+
+void parseArguments(char** args, int numOfArgs, options_ptr opts, fileList_ptr files){
+    int i;
+
+    for (i = 0; i < numOfArgs; i++) {
+        if (strcmp(args[i], "--keep-am") == 0)
+            opts->keepAm = TRUE;
+        else if (strcmp(args[i], "--obj") == 0)
+            opts->writeObj = TRUE;
+        else if (strcmp(args[i], "--image") == 0)
+            opts->writeImage = TRUE;
+        else if (strcmp(args[i], "--hex") == 0)
+            opts->writeHex = TRUE;
+        else if (strcmp(args[i], "--pipeline") == 0)
+            opts->pipeline = TRUE;
+        else if (strcmp(args[i], "--lex-threads") == 0) {
+            int numOfThreads = (i + 1 < numOfArgs) ? atoi(args[i + 1]) : 0;
+            if (numOfThreads < 1 || numOfThreads > MAX_THREADS)
+                report("Error: --lex-threads needs a number of threads between 1 and %d\n", MAX_THREADS);
+            else
+                opts->lexThreads = numOfThreads;
+            if (i + 1 < numOfArgs)
+                i++;
+        }
+        else if (strcmp(args[i], "--files-from") == 0) {
+            if (i + 1 >= numOfArgs)
+                report("Error: --files-from needs a file with a file name in every line (- for the standard input)\n");
+            else
+                addFromListFile(files, args[i + 1], TRUE);
+            if (i + 1 < numOfArgs)
+                i++;
+        }
+        else if (strcmp(args[i], "-j") == 0) {
+            int numOfJobs = (i + 1 < numOfArgs) ? atoi(args[i + 1]) : 0;
+            if (numOfJobs < 1 || numOfJobs > MAX_THREADS)
+                report("Error: -j needs a number of files between 1 and %d\n", MAX_THREADS);
+            else
+                opts->jobs = numOfJobs;
+            if (i + 1 < numOfArgs)
+                i++;
+        }
+        else if (strcmp(args[i], "--serve") == 0) {
+            if (i + 1 >= numOfArgs)
+                report("Error: --serve needs the path of a socket to listen on\n");
+            else
+                opts->serveSocket = args[i + 1];
+            if (i + 1 < numOfArgs)
+                i++;
+        }
+        else if (args[i][0] == MINUS)
+            report("Error: unknown option %s\n", args[i]);
+        else
+            addToFileList(files, args[i]);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include "decode.h"
+#include "fileList.h"
+
+/**
+ * Sets the options to their defaults (as when no option is given).
+ *
+ * @param opts The options.
+ */
+void initOptions(options_ptr opts);
+
+/**
+ * Lists the arguments of the command line, with every response file (@file) replaced by the arguments in it.
+ *
+ * @param argc The number of arguments (the first one, the name of the program, is skipped).
+ * @param argv The arguments.
+ * @return The list of arguments, or NULL if memory could not be allocated.
+ */
+fileList_ptr expandArguments(int argc, char** argv);
+
+/**
+ * Reads the options in a list of arguments, and adds the rest of the arguments (and the names
+ * of --files-from) to a list of files. The options are read first, so they apply to every file.
+ * Invalid options are reported (and ignored).
+ *
+ * @param args The arguments.
+ * @param numOfArgs The number of arguments.
+ * @param opts The options to set.
+ * @param files The list to add the files to.
+ */
+void parseArguments(char** args, int numOfArgs, options_ptr opts, fileList_ptr files);
+
+#endif /* COMMAND_LINE_H */
@@ -1,44 +1,573 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include "decode.h"
-#include "preprocess.h"
-#include "secondPass.h"
-#include "utils.h"
-#include "globals.h"
-
-
-void decodeFile(char* file){
-    char* asFileName;
-    char* amFileName;
-    st_ptr st_head = NULL;
-    symbol_ptr symbol_head  =  NULL;
-    wordTable_ptr wordTable_head  =  NULL;
-    asFileName = setOutputFile(file,".as");
-
-    if(fileExists(asFileName)==TRUE){
-
-        /*pre process on as file  and creat am file*/
-        amFileName = preProcessor(asFileName,file);
-
-        /*analyzing the whole am file, if there is an error, it returns NULL*/
-        st_head = lexer(amFileName);
-        symbol_head  = (st_head!=NULL)?st_head->symbol_head:NULL;
-
-        /*Performs the first of 2 passes (even if there was an error, it will skip everything).*/
-        wordTable_head = firstPass(st_head,symbol_head,amFileName);
-
-        /*Performs the second of 2 passes*/
-        secondPass(symbol_head,wordTable_head,file);
-
-        /*frees the allocated memory that created*/
-        SAFE_FREE(amFileName)
-        SAFE_FREE(asFileName)
-        freeStTable(st_head);
-        freeSymbolTable(symbol_head);
-        freeWordsTable(wordTable_head);
-    }
-    else{
-        printf("ERROR: the file %s doesn't exist\n",file);
-        return;
-    }
-}
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "decode.h"
+#include "preprocess.h"
+#include "secondPass.h"
+#include "diagnostics.h"
+#include "threadPool.h"
+#include "fileIO.h"
+#include "outputFile.h"
+#include "utils.h"
+#include "globals.h"
+
+/*The state of a file while it is decoded, passed from stage to stage*/
+typedef struct fileContext * fileContext_ptr;
+typedef struct fileContext{
+
+    /*The name of the file (without as ending) and the options*/
+    char* file;
+    options_ptr opts;
+
+    /*The names of the as and am files*/
+    char* asFileName;
+    char* amFileName;
+
+    /*Whether the as file exists (the other stages skip a file that does not)*/
+    int exists;
+
+    /*The text of the as file, and whether it was already read (with the files around it)*/
+    buffer_ptr asText;
+    int prefetched;
+
+    /*The text of the am file, and the tables built from it (allocated from the arena of the file)*/
+    buffer_ptr amText;
+    stTable_ptr table;
+    wordTable_ptr wordTable_head;
+    arena_ptr arena;
+
+    /*The messages reported while decoding the file (used when the stages run on other threads)*/
+    buffer_ptr diagnostics;
+
+}fileContext;
+
+/*A stage of decoding a file*/
+typedef void (*fileStage)(fileContext_ptr context);
+
+/*A stage of the pipeline, run on a thread of its own*/
+typedef struct pipelineStage{
+
+    /*The thread of the stage*/
+    pthread_t thread;
+
+    /*The stage to run on every file*/
+    fileStage run;
+
+    /*The files that wait for the stage, and the files that wait for the next stage (NULL for the last stage)*/
+    boundedQueue_ptr input;
+    boundedQueue_ptr output;
+
+}pipelineStage;
+
+/**
+ * Reads the as file and deploys its macros (the first stage).
+ *
+ * @param context The file.
+ */
+static void preprocessStage(fileContext_ptr context);
+
+/**
+ * Analyzes the am text into the sentence table and the symbol table.
+ *
+ * @param context The file.
+ */
+static void lexStage(fileContext_ptr context);
+
+/**
+ * Encodes the sentences into the word table (the first pass).
+ *
+ * @param context The file.
+ */
+static void firstPassStage(fileContext_ptr context);
+
+/**
+ * Fills the label words and writes the output files (the second pass, the last stage).
+ *
+ * @param context The file.
+ */
+static void secondPassStage(fileContext_ptr context);
+
+/*The stages of decoding a file, in order*/
+static const fileStage decodeStages[PIPELINE_STAGES] = {preprocessStage, lexStage, firstPassStage, secondPassStage};
+
+/**
+ * Initializes the context of a file before its first stage.
+ *
+ * @param context The context to initialize.
+ * @param file The name of the file (without as ending).
+ * @param opts The options given in the command line.
+ */
+static void initFileContext(fileContext_ptr context, char* file, options_ptr opts);
+
+/**
+ * Reads the as files of several files together, before their first stages.
+ *
+ * @param contexts The files.
+ * @param numOfContexts The number of files (up to IO_BATCH_SIZE).
+ */
+static void prefetchSources(fileContext_ptr* contexts, int numOfContexts);
+
+/**
+ * Decodes several files one after another on this thread, reading their as files
+ * and writing their outputs IO_BATCH_SIZE files at a time.
+ *
+ * @param files The names of the files to decode (without as ending).
+ * @param numOfFiles The number of files.
+ * @param opts The options given in the command line.
+ */
+static void decodeFilesBatched(char** files, int numOfFiles, options_ptr opts);
+
+/**
+ * Frees everything that was allocated for a file (not the context itself).
+ *
+ * @param context The file.
+ */
+static void freeFileContext(fileContext_ptr context);
+
+/**
+ * Runs a stage of the pipeline on every file that comes to it (the function of the thread of the stage).
+ * The last stage prints the messages of every file, the files come to it in the order of the command line.
+ *
+ * @param arg The stage.
+ * @return NULL.
+ */
+static void* pipelineStageLoop(void* arg);
+
+/**
+ * Reads the as files of some files together and puts the files into the first stage of the pipeline.
+ *
+ * @param first The first stage.
+ * @param contexts The files.
+ * @param numOfContexts The number of files.
+ */
+static void feedPipeline(pipelineStage* first, fileContext_ptr* contexts, int numOfContexts);
+
+/**
+ * Decodes several files in a pipeline: every stage runs on a thread of its own, and the stages are connected
+ * by queues of PIPELINE_QUEUE_SIZE files, so a file is preprocessed while the ones before it are encoded and written.
+ * If memory for a file cannot be allocated, the pipeline finishes the files before it, and that file and
+ * the ones after it are decoded one at a time on this thread (so the messages are still in the order of the files).
+ *
+ * @param files The names of the files to decode (without as ending).
+ * @param numOfFiles The number of files.
+ * @param opts The options given in the command line.
+ * @return 0 if the files were decoded, -1 if the pipeline could not be started (no file was decoded).
+ */
+static int decodeFilesPipelined(char** files, int numOfFiles, options_ptr opts);
+
+/*The files that are decoded together on a pool of threads*/
+typedef struct fileBatch{
+
+    /*The threads that decode the files*/
+    threadPool_ptr pool;
+
+    /*Protects the done flags of the files*/
+    pthread_mutex_t lock;
+
+    /*Signaled when a file is done*/
+    pthread_cond_t fileDone;
+
+}fileBatch;
+
+/*A file that is decoded by a thread of the pool*/
+typedef struct fileJob * fileJob_ptr;
+typedef struct fileJob{
+
+    /*The name of the file (without as ending) and the options*/
+    char* file;
+    options_ptr opts;
+
+    /*The place of the file in the command line, and the size of its as file*/
+    int index;
+    long size;
+
+    /*The messages reported while decoding the file, printed in the order of the files*/
+    buffer_ptr diagnostics;
+
+    /*Whether the file is done (protected by the lock of the batch)*/
+    int done;
+
+    /*The batch of the file*/
+    fileBatch* batch;
+
+}fileJob;
+
+/**
+ * Decodes a file of a batch, keeping its messages (run by a thread of the pool).
+ *
+ * @param arg The job of the file.
+ */
+static void decodeFileTask(void* arg);
+
+/**
+ * Compares 2 jobs so the larger file comes first (and files of the same size in the order of the command line).
+ *
+ * @param first A pointer to the first job.
+ * @param second A pointer to the second job.
+ * @return A negative number if the first job comes first, a positive number otherwise.
+ */
+static int compareJobSize(const void* first, const void* second);
+
+/**
+ * Finds the size of the as file of a file.
+ *
+ * @param file The name of the file (without as ending).
+ * @return The size of the as file, or 0 if it cannot be read.
+ */
+static long sourceSize(char* file);
+
+
+void decodeFile(char* file, options_ptr opts){
+    fileContext context;
+    int i;
+
+    initFileContext(&context, file, opts);
+    for (i = 0; i < PIPELINE_STAGES; i++)
+        decodeStages[i](&context);
+    freeFileContext(&context);
+}
+
+void decodeSource(char* file, buffer_ptr asText, options_ptr opts){
+    fileContext context;
+    int i;
+
+    initFileContext(&context, file, opts);
+    context.asText = asText;
+    context.prefetched = TRUE;
+    for (i = 0; i < PIPELINE_STAGES; i++)
+        decodeStages[i](&context);
+    freeFileContext(&context);
+}
+
+void decodeFiles(char** files, int numOfFiles, options_ptr opts){
+    fileBatch batch;
+    fileJob* jobs;
+    fileJob_ptr* order;
+    int i, numOfThreads = (opts->jobs < numOfFiles) ? opts->jobs : numOfFiles;
+
+    /*Every stage on a thread of its own*/
+    if(opts->pipeline == TRUE && numOfFiles > 1 && decodeFilesPipelined(files, numOfFiles, opts) == TRUE)
+        return;
+
+    /*One file at a time, on this thread*/
+    if(opts->pipeline == TRUE || numOfThreads <= 1){
+        decodeFilesBatched(files, numOfFiles, opts);
+        return;
+    }
+
+    jobs = (fileJob*) calloc(numOfFiles, sizeof(fileJob));
+    order = (fileJob_ptr*) malloc(numOfFiles * sizeof(fileJob_ptr));
+    /*Without memory for the jobs, the files are decoded one at a time on this thread*/
+    if(jobs == NULL || order == NULL){
+        SAFE_FREE(jobs)
+        SAFE_FREE(order)
+        decodeFilesBatched(files, numOfFiles, opts);
+        return;
+    }
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.fileDone, NULL);
+    batch.pool = createThreadPool(numOfThreads);
+
+    for (i = 0; i < numOfFiles; i++) {
+        jobs[i].file = files[i];
+        jobs[i].opts = opts;
+        jobs[i].index = i;
+        jobs[i].size = sourceSize(files[i]);
+        jobs[i].diagnostics = createBuffer();
+        jobs[i].done = FALSE;
+        jobs[i].batch = &batch;
+        order[i] = &jobs[i];
+    }
+
+    /*The largest files are started first, so a large file does not start last and keep the others waiting*/
+    qsort(order, numOfFiles, sizeof(fileJob_ptr), compareJobSize);
+    for (i = 0; i < numOfFiles; i++) {
+        if(order[i]->diagnostics == NULL)
+            continue;
+        if(batch.pool == NULL || submitTask(batch.pool, decodeFileTask, order[i]) == FALSE)
+            decodeFileTask(order[i]);
+    }
+
+    /*Prints the messages of every file in the order of the files, as soon as the file and the ones before it are done
+     *(a file without a buffer for its messages is decoded here, when it is its turn to print them)*/
+    for (i = 0; i < numOfFiles; i++) {
+        if(jobs[i].diagnostics == NULL){
+            decodeFile(jobs[i].file, opts);
+            continue;
+        }
+        pthread_mutex_lock(&batch.lock);
+        while (jobs[i].done == FALSE)
+            pthread_cond_wait(&batch.fileDone, &batch.lock);
+        pthread_mutex_unlock(&batch.lock);
+        fwrite(jobs[i].diagnostics->text, 1, jobs[i].diagnostics->length, stdout);
+        freeBuffer(jobs[i].diagnostics);
+    }
+
+    if(batch.pool != NULL){
+        waitForTasks(batch.pool);
+        freeThreadPool(batch.pool);
+    }
+    pthread_cond_destroy(&batch.fileDone);
+    pthread_mutex_destroy(&batch.lock);
+    free(order);
+    free(jobs);
+}
+
+static void preprocessStage(fileContext_ptr context){
+    if(context->prefetched==FALSE && context->asFileName!=NULL)
+        context->asText = readWholeFile(context->asFileName);
+    if(context->asText==NULL){
+        report("ERROR: the file %s doesn't exist\n",context->file);
+        return;
+    }
+    context->exists = TRUE;
+
+    /*All the tables of the file are allocated from one arena*/
+    context->arena = createArena();
+
+    /*pre process on as file, the am text is kept in memory*/
+    context->amFileName = setOutputFile(context->file,".am");
+    context->amText = preProcessor(context->asText,context->file);
+    freeBuffer(context->asText);
+    context->asText = NULL;
+
+    /*The am file is written only when asked for, together with the other outputs of the file*/
+    if(context->amText!=NULL && context->opts->keepAm==TRUE)
+        commitOutputFile(context->file,".am",context->amText->text,context->amText->length);
+}
+
+static void lexStage(fileContext_ptr context){
+    if(context->exists==FALSE)return;
+
+    /*analyzing the whole am text, if there is an error, it returns NULL*/
+    context->table = (context->arena!=NULL)?lexer(context->amText,context->amFileName,context->opts->lexThreads,context->arena):NULL;
+}
+
+static void firstPassStage(fileContext_ptr context){
+    if(context->exists==FALSE)return;
+
+    /*Performs the first of 2 passes (even if there was an error, it will skip everything).*/
+    context->wordTable_head = firstPass(context->table,context->amFileName,context->arena);
+}
+
+static void secondPassStage(fileContext_ptr context){
+    if(context->exists==FALSE)return;
+
+    /*Performs the second of 2 passes*/
+    secondPass((context->table!=NULL)?context->table->symbols:NULL,context->wordTable_head,context->file,context->opts);
+}
+
+static void initFileContext(fileContext_ptr context, char* file, options_ptr opts){
+    context->file = file;
+    context->opts = opts;
+    context->asFileName = setOutputFile(file,".as");
+    context->amFileName = NULL;
+    context->exists = FALSE;
+    context->asText = NULL;
+    context->prefetched = FALSE;
+    context->amText = NULL;
+    context->table = NULL;
+    context->wordTable_head = NULL;
+    context->arena = NULL;
+    context->diagnostics = NULL;
+}
+
+static void freeFileContext(fileContext_ptr context){
+
+    /*frees the allocated memory that created (the tables are freed with the arena)*/
+    SAFE_FREE(context->amFileName)
+    SAFE_FREE(context->asFileName)
+    freeBuffer(context->asText);
+    freeBuffer(context->amText);
+    freeArena(context->arena);
+    freeBuffer(context->diagnostics);
+}
+
+static void prefetchSources(fileContext_ptr* contexts, int numOfContexts){
+    char* asFileNames[IO_BATCH_SIZE];
+    buffer_ptr asTexts[IO_BATCH_SIZE];
+    int i;
+
+    for (i = 0; i < numOfContexts; i++)
+        asFileNames[i] = contexts[i]->asFileName;
+    readFiles(asFileNames, numOfContexts, asTexts);
+    for (i = 0; i < numOfContexts; i++) {
+        contexts[i]->asText = asTexts[i];
+        contexts[i]->prefetched = TRUE;
+    }
+}
+
+static void decodeFilesBatched(char** files, int numOfFiles, options_ptr opts){
+    fileContext contexts[IO_BATCH_SIZE];
+    fileContext_ptr batch[IO_BATCH_SIZE];
+    outputBatch_ptr outputs = createOutputBatch();
+    int start, i, j;
+
+    /*The outputs of the files of a batch are kept and committed together (right away if there is no batch),
+     *and an output that cannot be written is reported by its name when the batch is flushed*/
+    setOutputBatch(outputs);
+    for (start = 0; start < numOfFiles; start += IO_BATCH_SIZE) {
+        int count = (numOfFiles - start < IO_BATCH_SIZE) ? numOfFiles - start : IO_BATCH_SIZE;
+
+        for (i = 0; i < count; i++) {
+            initFileContext(&contexts[i], files[start + i], opts);
+            batch[i] = &contexts[i];
+        }
+        prefetchSources(batch, count);
+        for (i = 0; i < count; i++) {
+            for (j = 0; j < PIPELINE_STAGES; j++)
+                decodeStages[j](&contexts[i]);
+            freeFileContext(&contexts[i]);
+        }
+        flushOutputBatch(outputs);
+    }
+    setOutputBatch(NULL);
+    freeOutputBatch(outputs);
+}
+
+static int decodeFilesPipelined(char** files, int numOfFiles, options_ptr opts){
+    pipelineStage stages[PIPELINE_STAGES];
+    fileContext_ptr batch[IO_BATCH_SIZE];
+    int i, count = 0, numOfStarted = 0, numOfQueued = 0, failed = FALSE;
+
+    /*A queue in front of every stage*/
+    for (i = 0; i < PIPELINE_STAGES; i++) {
+        stages[i].run = decodeStages[i];
+        stages[i].input = createBoundedQueue(PIPELINE_QUEUE_SIZE);
+        if(stages[i].input == NULL)
+            failed = TRUE;
+    }
+    for (i = 0; i < PIPELINE_STAGES; i++)
+        stages[i].output = (i + 1 < PIPELINE_STAGES) ? stages[i + 1].input : NULL;
+
+    /*Starts the threads of the stages, a stage that did not start stops the ones that did*/
+    for (i = 0; i < PIPELINE_STAGES && failed == FALSE; i++) {
+        if(pthread_create(&stages[i].thread, NULL, pipelineStageLoop, &stages[i]) != 0)
+            failed = TRUE;
+        else
+            numOfStarted++;
+    }
+
+    /*The files go into the first stage in the order of the command line, and come out of the last one in the same order
+     *(their as files are read IO_BATCH_SIZE at a time, ahead of the stages)*/
+    for (i = 0; i < numOfFiles && failed == FALSE; i++) {
+        fileContext_ptr context = (fileContext_ptr) malloc(sizeof(fileContext));
+        if(context != NULL){
+            initFileContext(context, files[i], opts);
+            context->diagnostics = createBuffer();
+        }
+        if(context == NULL || context->diagnostics == NULL){
+            if(context != NULL){
+                freeFileContext(context);
+                free(context);
+            }
+            break;
+        }
+        batch[count++] = context;
+        numOfQueued++;
+        if(count == IO_BATCH_SIZE){
+            feedPipeline(&stages[0], batch, count);
+            count = 0;
+        }
+    }
+    if(count > 0)
+        feedPipeline(&stages[0], batch, count);
+
+    /*Every stage closes the queue of the next one once it is done*/
+    if(numOfStarted > 0)
+        closeQueue(stages[0].input);
+    for (i = 0; i < numOfStarted; i++)
+        pthread_join(stages[i].thread, NULL);
+    for (i = 0; i < PIPELINE_STAGES; i++)
+        freeBoundedQueue(stages[i].input);
+
+    /*The files that did not get into the pipeline are decoded after the ones that did*/
+    if(failed == FALSE && numOfQueued < numOfFiles)
+        decodeFilesBatched(files + numOfQueued, numOfFiles - numOfQueued, opts);
+    return (failed == FALSE) ? TRUE : FALSE;
+}
+
+static void feedPipeline(pipelineStage* first, fileContext_ptr* contexts, int numOfContexts){
+    int i;
+
+    prefetchSources(contexts, numOfContexts);
+    for (i = 0; i < numOfContexts; i++)
+        pushToQueue(first->input, contexts[i]);
+}
+
+static void* pipelineStageLoop(void* arg){
+    pipelineStage* stage = (pipelineStage*) arg;
+    fileContext_ptr context;
+    outputBatch_ptr outputs = NULL;
+    int numOfFiles = 0;
+
+    /*The last stage keeps the outputs of IO_BATCH_SIZE files and commits them together
+     *(an output that cannot be written is printed by its name, after the messages of its file)*/
+    if(stage->output == NULL){
+        outputs = createOutputBatch();
+        setOutputBatch(outputs);
+    }
+
+    while ((context = (fileContext_ptr) popFromQueue(stage->input)) != NULL) {
+
+        /*The messages of the file are kept with it*/
+        setDiagnosticsBuffer(context->diagnostics);
+        stage->run(context);
+        setDiagnosticsBuffer(NULL);
+
+        if(stage->output != NULL)
+            pushToQueue(stage->output, context);
+        else{
+            fwrite(context->diagnostics->text, 1, context->diagnostics->length, stdout);
+            freeFileContext(context);
+            free(context);
+            if(++numOfFiles % IO_BATCH_SIZE == 0)
+                flushOutputBatch(outputs);
+        }
+    }
+    if(stage->output != NULL)
+        closeQueue(stage->output);
+    else{
+        flushOutputBatch(outputs);
+        setOutputBatch(NULL);
+        freeOutputBatch(outputs);
+    }
+    return NULL;
+}
+
+static void decodeFileTask(void* arg){
+    fileJob_ptr job = (fileJob_ptr) arg;
+    buffer_ptr previous = getDiagnosticsBuffer();
+
+    /*Every file is decoded with tables of its own, only its messages are kept until it is its turn to print them*/
+    setDiagnosticsBuffer(job->diagnostics);
+    decodeFile(job->file, job->opts);
+    setDiagnosticsBuffer(previous);
+
+    pthread_mutex_lock(&job->batch->lock);
+    job->done = TRUE;
+    pthread_cond_broadcast(&job->batch->fileDone);
+    pthread_mutex_unlock(&job->batch->lock);
+}
+
+static int compareJobSize(const void* first, const void* second){
+    fileJob_ptr firstJob = *(const fileJob_ptr*) first;
+    fileJob_ptr secondJob = *(const fileJob_ptr*) second;
+
+    if(firstJob->size != secondJob->size)
+        return (firstJob->size > secondJob->size) ? -1 : 1;
+    return firstJob->index - secondJob->index;
+}
+
+static long sourceSize(char* file){
+    char* asFileName = setOutputFile(file,".as");
+    long size;
+
+    if(asFileName == NULL)
+        return 0;
+    size = fileSize(asFileName);
+    free(asFileName);
+    return size;
+}
@@ -1,6 +1,66 @@
-/**
- * Decodes the contents of a file.
- *
- * @param file The name of the file to decode (without as ending).
- */
-void decodeFile(char* file);
+#ifndef DECODE_H
+#define DECODE_H
+
+#include "buffer.h"
+
+#define PIPELINE_STAGES 4 /*The stages of decoding a file: preprocess, lex, first pass and second pass*/
+#define PIPELINE_QUEUE_SIZE 4 /*The number of files that can wait for a stage of the pipeline*/
+
+/*Options given in the command line, applied to every file*/
+typedef struct options * options_ptr;
+typedef struct options{
+
+    /*Whether to keep the am file (the output of the pre processor) on disk*/
+    int keepAm;
+
+    /*The maximum number of threads that lex a single file*/
+    int lexThreads;
+
+    /*The number of files that are assembled at the same time*/
+    int jobs;
+
+    /*Whether to run every stage of decoding on a thread of its own, passing the files from stage to stage*/
+    int pipeline;
+
+    /*Whether to also write the binary object file (.obj)*/
+    int writeObj;
+
+    /*Whether to also write the memory image (.img) and the Intel HEX file of the image (.hex)*/
+    int writeImage;
+    int writeHex;
+
+    /*The path of the socket to listen on as a server (NULL to assemble the files of the command line)*/
+    char* serveSocket;
+
+}options;
+
+/**
+ * Decodes the contents of a file.
+ *
+ * @param file The name of the file to decode (without as ending).
+ * @param opts The options given in the command line.
+ */
+void decodeFile(char* file, options_ptr opts);
+
+/**
+ * Decodes the contents of a file whose as text was already read (or sent by a client of the server).
+ *
+ * @param file The name of the file to decode (without as ending).
+ * @param asText The text of the as file, or NULL if it does not exist (freed by the function).
+ * @param opts The options given in the command line.
+ */
+void decodeSource(char* file, buffer_ptr asText, options_ptr opts);
+
+/**
+ * Decodes the contents of several files, in a pipeline of a thread per stage when opts->pipeline is set,
+ * otherwise on a pool of opts->jobs threads when there is more than one.
+ * The largest files are started first, and the messages of every file are printed
+ * in the order of the files (exactly as when they are decoded one after another).
+ *
+ * @param files The names of the files to decode (without as ending).
+ * @param numOfFiles The number of files.
+ * @param opts The options given in the command line.
+ */
+void decodeFiles(char** files, int numOfFiles, options_ptr opts);
+
+#endif /* DECODE_H */
@@ -0,0 +1,85 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include "diagnostics.h"
+#include "globals.h"
+
+/*The key of the diagnostics buffer of every thread (created once)*/
+static pthread_key_t bufferKey;
+static pthread_once_t bufferKeyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Creates the key of the diagnostics buffers.
+ */
+static void createBufferKey(void);
+
+void report(const char* format, ...){
+    buffer_ptr buffer;
+    char message[DIAGNOSTIC_INITIAL_SIZE];
+    char* longMessage;
+    va_list values;
+    int length;
+
+    /*Without a buffer the message is printed right away*/
+    pthread_once(&bufferKeyOnce, createBufferKey);
+    buffer = (buffer_ptr) pthread_getspecific(bufferKey);
+    if(buffer == NULL){
+        va_start(values, format);
+        vprintf(format, values);
+        va_end(values);
+        return;
+    }
+
+    va_start(values, format);
+    length = vsnprintf(message, sizeof(message), format, values);
+    va_end(values);
+    if(length < 0)
+        return;
+    if(length < (int)sizeof(message)){
+        appendToBuffer(buffer, message, length);
+        return;
+    }
+
+    /*A long message (a long file name) is formatted again into memory of its size (or kept cut if there is none)*/
+    longMessage = (char*) malloc(length + 1);
+    if(longMessage == NULL){
+        appendToBuffer(buffer, message, (long) strlen(message));
+        return;
+    }
+    va_start(values, format);
+    vsnprintf(longMessage, length + 1, format, values);
+    va_end(values);
+    appendToBuffer(buffer, longMessage, length);
+    free(longMessage);
+}
+
+int setDiagnosticsBuffer(buffer_ptr buffer){
+    pthread_once(&bufferKeyOnce, createBufferKey);
+    if(pthread_setspecific(bufferKey, buffer) != 0)
+        return FALSE;
+    return TRUE;
+}
+
+buffer_ptr getDiagnosticsBuffer(void){
+    pthread_once(&bufferKeyOnce, createBufferKey);
+    return (buffer_ptr) pthread_getspecific(bufferKey);
+}
+
+void reportText(const char* text, long length){
+    buffer_ptr buffer = getDiagnosticsBuffer();
+
+    if(length <= 0)
+        return;
+    if(buffer == NULL)
+        fwrite(text, 1, length, stdout);
+    else
+        appendToBuffer(buffer, text, length);
+}
+
+static void createBufferKey(void){
+    pthread_key_create(&bufferKey, NULL);
+}
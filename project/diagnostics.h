@@ -0,0 +1,41 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include "buffer.h"
+
+#define DIAGNOSTIC_INITIAL_SIZE 256 /*The size of a message that is formatted without allocating memory*/
+
+/**
+ * Reports a message of the assembler (an error or a warning), formatted the same way printf formats it.
+ * If a diagnostics buffer was set for the calling thread, the message is kept in it instead of printed.
+ *
+ * @param format The format of the message.
+ * @param ... The values of the message.
+ */
+void report(const char* format, ...);
+
+/**
+ * Sets the buffer that keeps the messages reported by the calling thread.
+ *
+ * @param buffer The buffer to keep the messages in, or NULL to print them right away.
+ * @return 0 if the buffer was set, -1 otherwise.
+ */
+int setDiagnosticsBuffer(buffer_ptr buffer);
+
+/**
+ * Gets the buffer that keeps the messages reported by the calling thread.
+ *
+ * @return The buffer, or NULL if the messages of the thread are printed right away.
+ */
+buffer_ptr getDiagnosticsBuffer(void);
+
+/**
+ * Reports text that was already formatted (messages that were kept and are passed on in order).
+ * If a diagnostics buffer was set for the calling thread, the text is kept in it instead of printed.
+ *
+ * @param text The text.
+ * @param length The length of the text.
+ */
+void reportText(const char* text, long length);
+
+#endif /* DIAGNOSTICS_H */
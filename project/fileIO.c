@@ -0,0 +1,672 @@
+#ifdef USE_IO_URING
+#define _GNU_SOURCE
+#else
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "fileIO.h"
+#include "globals.h"
+#include "utils.h"
+
+#ifdef USE_IO_URING
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/*An io_uring ring: the submission queue and the completion queue shared with the kernel*/
+typedef struct ioRing{
+
+    /*The file descriptor of the ring*/
+    int fd;
+
+    /*The submission queue, and the entries of the operations it points to*/
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    struct io_uring_sqe* sqes;
+
+    /*The completion queue*/
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    struct io_uring_cqe* cqes;
+
+    /*The memory the queues are mapped to*/
+    void* sqRing;
+    size_t sqRingSize;
+    void* cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+
+}ioRing;
+
+/*An operation that is submitted to the ring*/
+typedef struct ioOperation{
+
+    /*The operation (IORING_OP_...) and the file descriptor it is done on (AT_FDCWD for a path)*/
+    int opcode;
+    int fd;
+
+    /*The buffer to read/write, or the path to open/rename/unlink*/
+    const void* addr;
+
+    /*The length of the buffer (the mode of a new file for IORING_OP_OPENAT, AT_FDCWD for IORING_OP_RENAMEAT)*/
+    unsigned int len;
+
+    /*The offset in the file to read/write at*/
+    unsigned long offset;
+
+    /*The new path of IORING_OP_RENAMEAT (NULL for the other operations)*/
+    const char* newPath;
+
+    /*The flags of IORING_OP_OPENAT*/
+    int flags;
+
+    /*The result of the operation (a negative errno if it failed)*/
+    int result;
+
+}ioOperation;
+
+/*The ring of every thread (NULL until the thread uses one), kept for all the file I/O of the thread*/
+static pthread_key_t ringKey;
+static pthread_once_t ringKeyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Creates the key of the ring of every thread (a ring is closed when its thread exits).
+ */
+static void createRingKey(void);
+
+/**
+ * Gets the ring of the calling thread, and sets it up the first time the thread asks for it.
+ *
+ * @return The ring, or NULL if io_uring is not available.
+ */
+static ioRing* threadRing(void);
+
+/**
+ * Closes the ring of a thread that exits.
+ *
+ * @param ring The ring.
+ */
+static void freeThreadRing(void* ring);
+
+/**
+ * Sets up a ring of IO_RING_ENTRIES entries.
+ *
+ * @param ring The ring to set up.
+ * @return 0 if the ring was set up, -1 if io_uring is not available (or too old to open and rename files).
+ */
+static int openRing(ioRing* ring);
+
+/**
+ * Frees a ring.
+ *
+ * @param ring The ring.
+ */
+static void closeRing(ioRing* ring);
+
+/**
+ * Submits operations to the ring and waits until they all complete, IO_RING_ENTRIES at a time.
+ * The kernel may take only some of the entries it is given, the rest are submitted again until it takes them all.
+ *
+ * @param ring The ring.
+ * @param operations The operations (the result of every operation is set).
+ * @param numOfOperations The number of operations.
+ * @return 0 if all the operations completed, -1 if the ring failed (the rest of the operations failed with it).
+ */
+static int runOperations(ioRing* ring, ioOperation* operations, int numOfOperations);
+
+/**
+ * Sets an operation.
+ *
+ * @param operation The operation to set.
+ * @param opcode The operation (IORING_OP_...).
+ * @param fd The file descriptor.
+ * @param addr The buffer or path.
+ * @param len The length of the buffer (or the mode/new directory).
+ * @param offset The offset in the file.
+ */
+static void setOperation(ioOperation* operation, int opcode, int fd, const void* addr, unsigned int len, unsigned long offset);
+
+/**
+ * Reads several whole files through the ring: all the files are opened together,
+ * then read together IO_READ_SIZE bytes at a time until they end, and closed together.
+ *
+ * @param ring The ring.
+ * @param fileNames The names of the files.
+ * @param numOfFiles The number of files.
+ * @param texts Set to the content of every file (NULL if it cannot be read).
+ * @return 0 if the files were read, -1 if memory could not be allocated (no file was read).
+ */
+static int readFilesRing(ioRing* ring, char** fileNames, int numOfFiles, buffer_ptr* texts);
+
+/**
+ * Replaces several files through the ring: the temporary files are opened, written,
+ * closed and renamed to the files together.
+ *
+ * @param ring The ring.
+ * @param writes The files and their content.
+ * @param numOfWrites The number of files.
+ * @return 0 if the files were handled, -1 if memory could not be allocated (no file was replaced).
+ */
+static int replaceFilesRing(ioRing* ring, fileWrite* writes, int numOfWrites);
+
+/**
+ * Removes several files through the ring.
+ *
+ * @param ring The ring.
+ * @param fileNames The names of the files.
+ * @param numOfFiles The number of files.
+ * @param results Set to 0 for every file that is not there anymore, -1 for a file that cannot be removed.
+ * @return 0 if the files were handled, -1 if memory could not be allocated (no file was removed).
+ */
+static int removeFilesRing(ioRing* ring, char** fileNames, int numOfFiles, int* results);
+#endif
+
+/*The number of temporary files this process has named, and its lock*/
+static unsigned long tempCounter = 0;
+static pthread_mutex_t tempLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Names a temporary file next to a file. The name has the id of the process and a number no other
+ * temporary file of the process has, so two writers of the same file never write to the same temporary file.
+ *
+ * @param fileName The name of the file.
+ * @return A new string with the name (fileName.PID.NUMBER.tmp), or NULL if memory could not be allocated
+ *         (the file is not replaced then, and the caller reports it by its name).
+ */
+static char* tempNameOf(const char* fileName);
+
+/**
+ * Replaces a file with stdio (through a temporary file that is renamed to it).
+ *
+ * @param write The file and its content (its result is set).
+ */
+static void replaceFile(fileWrite* write);
+
+buffer_ptr readWholeFile(const char* fileName){
+    FILE* file = fopen(fileName, "rb");
+    buffer_ptr text;
+
+    if(file==NULL)
+        return NULL;
+    text = readWholeStream(file);
+    fclose(file);
+    return text;
+}
+
+buffer_ptr readWholeStream(FILE* stream){
+    buffer_ptr text = createBuffer();
+    size_t count;
+
+    if(text==NULL)
+        return NULL;
+
+    /*Reads straight into the buffer until the stream ends*/
+    do {
+        if(reserveBuffer(text, IO_READ_SIZE)==FALSE){
+            freeBuffer(text);
+            return NULL;
+        }
+        count = fread(text->text + text->length, 1, IO_READ_SIZE, stream);
+        text->length += (long) count;
+    } while (count == IO_READ_SIZE);
+    text->text[text->length] = NULL_TERM;
+
+    if(ferror(stream)){
+        freeBuffer(text);
+        return NULL;
+    }
+    return text;
+}
+
+long fileSize(const char* fileName){
+    struct stat status;
+
+    if(stat(fileName, &status) != 0)
+        return 0;
+    return (long) status.st_size;
+}
+
+void readFiles(char** fileNames, int numOfFiles, buffer_ptr* texts){
+    int i;
+#ifdef USE_IO_URING
+    ioRing* ring = threadRing();
+
+    if(ring != NULL && readFilesRing(ring, fileNames, numOfFiles, texts)==TRUE)
+        return;
+#endif
+
+    for (i = 0; i < numOfFiles; i++)
+        texts[i] = (fileNames[i]!=NULL)?readWholeFile(fileNames[i]):NULL;
+}
+
+void replaceFiles(fileWrite* writes, int numOfWrites){
+    int i;
+#ifdef USE_IO_URING
+    ioRing* ring = (numOfWrites > 0) ? threadRing() : NULL;
+
+    if(ring != NULL && replaceFilesRing(ring, writes, numOfWrites)==TRUE)
+        return;
+#endif
+
+    for (i = 0; i < numOfWrites; i++)
+        replaceFile(&writes[i]);
+}
+
+void removeFiles(char** fileNames, int numOfFiles, int* results){
+    int i;
+#ifdef USE_IO_URING
+    ioRing* ring = (numOfFiles > 0) ? threadRing() : NULL;
+
+    if(ring != NULL && removeFilesRing(ring, fileNames, numOfFiles, results)==TRUE)
+        return;
+#endif
+
+    /*A file that is not there (remove sets errno to ENOENT) is as good as removed*/
+    for (i = 0; i < numOfFiles; i++) {
+        errno = 0;
+        results[i] = (remove(fileNames[i]) == 0 || errno == ENOENT) ? TRUE : FALSE;
+    }
+}
+
+static char* tempNameOf(const char* fileName){
+    char* tempName = (char*) malloc(strlen(fileName) + IO_TEMP_NAME_EXTRA + strlen(IO_TEMP_EXTENSION) + 1);
+    unsigned long number;
+
+    if(tempName==NULL)
+        return NULL;
+    pthread_mutex_lock(&tempLock);
+    number = tempCounter++;
+    pthread_mutex_unlock(&tempLock);
+    sprintf(tempName, "%s.%ld.%lu%s", fileName, (long) getpid(), number, IO_TEMP_EXTENSION);
+    return tempName;
+}
+
+static void replaceFile(fileWrite* write){
+    char* tempName = tempNameOf(write->fileName);
+    FILE* tempFile;
+
+    write->result = FALSE;
+    if(tempName==NULL)return;
+
+    /*Writes the content next to the file, and replaces the file with it at once*/
+    tempFile = fopen(tempName, "wb");
+    if(tempFile!=NULL){
+        write->result = (fwrite(write->text, 1, write->length, tempFile) == (size_t)write->length) ? TRUE : FALSE;
+        if(fclose(tempFile) != 0)
+            write->result = FALSE;
+        if(write->result==FALSE || rename(tempName, write->fileName) != 0){
+            remove(tempName);
+            write->result = FALSE;
+        }
+    }
+    free(tempName);
+}
+
+#ifdef USE_IO_URING
+static void createRingKey(void){
+    pthread_key_create(&ringKey, freeThreadRing);
+}
+
+static ioRing* threadRing(void){
+    ioRing* ring;
+
+    pthread_once(&ringKeyOnce, createRingKey);
+    ring = (ioRing*) pthread_getspecific(ringKey);
+    if(ring == NULL){
+
+        /*A thread that cannot set up a ring keeps one without a file descriptor, so it does not try again*/
+        ring = (ioRing*) malloc(sizeof(ioRing));
+        if(ring == NULL)
+            return NULL;
+        if(openRing(ring) == FALSE)
+            ring->fd = -1;
+        if(pthread_setspecific(ringKey, ring) != 0){
+            freeThreadRing(ring);
+            return NULL;
+        }
+    }
+    return (ring->fd >= 0) ? ring : NULL;
+}
+
+static void freeThreadRing(void* ring){
+    if(((ioRing*) ring)->fd >= 0)
+        closeRing((ioRing*) ring);
+    free(ring);
+}
+
+static int openRing(ioRing* ring){
+    struct io_uring_params params;
+
+    memset(&params, 0, sizeof(params));
+    ring->fd = (int) syscall(__NR_io_uring_setup, IO_RING_ENTRIES, &params);
+    if(ring->fd < 0)
+        return FALSE;
+
+    /*Opening, renaming and unlinking files through the ring came with Linux 5.11, the features of 5.12 mark it*/
+    if(!(params.features & IORING_FEAT_NATIVE_WORKERS)){
+        close(ring->fd);
+        return FALSE;
+    }
+
+    /*Maps the queues and the entries of the operations*/
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQ_RING);
+    ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe*) mmap(NULL, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, IORING_OFF_SQES);
+    if(ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || (void*) ring->sqes == MAP_FAILED){
+        if(ring->sqRing != MAP_FAILED)
+            munmap(ring->sqRing, ring->sqRingSize);
+        if(ring->cqRing != MAP_FAILED)
+            munmap(ring->cqRing, ring->cqRingSize);
+        if((void*) ring->sqes != MAP_FAILED)
+            munmap(ring->sqes, ring->sqesSize);
+        close(ring->fd);
+        return FALSE;
+    }
+
+    ring->sqHead = (unsigned*) ((char*) ring->sqRing + params.sq_off.head);
+    ring->sqTail = (unsigned*) ((char*) ring->sqRing + params.sq_off.tail);
+    ring->sqMask = (unsigned*) ((char*) ring->sqRing + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned*) ((char*) ring->sqRing + params.sq_off.array);
+    ring->cqHead = (unsigned*) ((char*) ring->cqRing + params.cq_off.head);
+    ring->cqTail = (unsigned*) ((char*) ring->cqRing + params.cq_off.tail);
+    ring->cqMask = (unsigned*) ((char*) ring->cqRing + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*) ((char*) ring->cqRing + params.cq_off.cqes);
+    return TRUE;
+}
+
+static void closeRing(ioRing* ring){
+    munmap(ring->sqes, ring->sqesSize);
+    munmap(ring->cqRing, ring->cqRingSize);
+    munmap(ring->sqRing, ring->sqRingSize);
+    close(ring->fd);
+}
+
+static int runOperations(ioRing* ring, ioOperation* operations, int numOfOperations){
+    int start, i, failed = FALSE;
+
+    for (i = 0; i < numOfOperations; i++)
+        operations[i].result = -EIO;
+
+    for (start = 0; start < numOfOperations && failed == FALSE; start += IO_RING_ENTRIES) {
+        int count = (numOfOperations - start < IO_RING_ENTRIES) ? numOfOperations - start : IO_RING_ENTRIES;
+        int taken = 0, completed = 0;
+        unsigned tail = *ring->sqTail, head;
+        long submitted;
+
+        /*Puts the operations in the submission queue (the index of an operation comes back with its completion)*/
+        for (i = 0; i < count; i++) {
+            unsigned index = tail & *ring->sqMask;
+            struct io_uring_sqe* entry = &ring->sqes[index];
+            ioOperation* operation = &operations[start + i];
+
+            memset(entry, 0, sizeof(struct io_uring_sqe));
+            entry->opcode = (unsigned char) operation->opcode;
+            entry->fd = operation->fd;
+            entry->addr = (unsigned long) operation->addr;
+            entry->len = operation->len;
+            if(operation->newPath != NULL)
+                entry->addr2 = (unsigned long) operation->newPath;
+            else
+                entry->off = operation->offset;
+            entry->open_flags = (unsigned int) operation->flags;
+            entry->user_data = (unsigned long) (start + i);
+            ring->sqArray[index] = index;
+            tail++;
+        }
+        __atomic_store_n(ring->sqTail, tail, __ATOMIC_RELEASE);
+
+        /*Submits them with a single system call, which also waits for all of them to complete. The kernel may take
+         *only some of them (it waits for none then), and the ones it did not take are submitted again*/
+        while (taken < count) {
+            submitted = syscall(__NR_io_uring_enter, ring->fd, count - taken, count - taken, IORING_ENTER_GETEVENTS, NULL, 0);
+            if(submitted < 0 && errno == EINTR)
+                continue;
+            if(submitted <= 0){
+
+                /*The ring failed: the entries it did not take are taken back (they keep -EIO),
+                 *and only the ones it took are waited for*/
+                __atomic_store_n(ring->sqTail, __atomic_load_n(ring->sqHead, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+                failed = TRUE;
+                break;
+            }
+            taken += (int) submitted;
+        }
+
+        head = *ring->cqHead;
+        while (completed < taken) {
+            struct io_uring_cqe* completion;
+
+            /*Waits for more completions (the ones taken so far are given back to the kernel first)*/
+            if(head == __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)){
+                __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+                submitted = syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+                if(submitted < 0 && errno != EINTR)
+                    return FALSE;
+                continue;
+            }
+            completion = &ring->cqes[head & *ring->cqMask];
+            if(completion->user_data < (unsigned long) numOfOperations)
+                operations[completion->user_data].result = completion->res;
+            head++;
+            completed++;
+        }
+        __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+    return (failed == FALSE) ? TRUE : FALSE;
+}
+
+static void setOperation(ioOperation* operation, int opcode, int fd, const void* addr, unsigned int len, unsigned long offset){
+    operation->opcode = opcode;
+    operation->fd = fd;
+    operation->addr = addr;
+    operation->len = len;
+    operation->offset = offset;
+    operation->newPath = NULL;
+    operation->flags = 0;
+    operation->result = 0;
+}
+
+static int readFilesRing(ioRing* ring, char** fileNames, int numOfFiles, buffer_ptr* texts){
+    ioOperation* operations = (ioOperation*) malloc(numOfFiles * sizeof(ioOperation));
+    int* fds = (int*) malloc(numOfFiles * sizeof(int));
+    int* ended = (int*) malloc(numOfFiles * sizeof(int));
+    int* files = (int*) malloc(numOfFiles * sizeof(int));
+    int i, k, count = 0;
+
+    if(operations==NULL || fds==NULL || ended==NULL || files==NULL){
+        SAFE_FREE(operations)
+        SAFE_FREE(fds)
+        SAFE_FREE(ended)
+        SAFE_FREE(files)
+        return FALSE;
+    }
+
+    /*Opens all the files*/
+    for (i = 0; i < numOfFiles; i++) {
+        texts[i] = NULL;
+        fds[i] = -1;
+        ended[i] = TRUE;
+        if(fileNames[i] != NULL){
+            setOperation(&operations[count], IORING_OP_OPENAT, AT_FDCWD, fileNames[i], 0, 0);
+            operations[count].flags = O_RDONLY;
+            files[count++] = i;
+        }
+    }
+    runOperations(ring, operations, count);
+    for (k = 0; k < count; k++) {
+        i = files[k];
+        if(operations[k].result >= 0){
+            fds[i] = operations[k].result;
+            texts[i] = createBuffer();
+            ended[i] = (texts[i] == NULL) ? TRUE : FALSE;
+        }
+    }
+
+    /*Reads all the files that did not end yet, IO_READ_SIZE bytes of each in every round*/
+    do {
+        count = 0;
+        for (i = 0; i < numOfFiles; i++) {
+            if(ended[i] == TRUE)
+                continue;
+            if(reserveBuffer(texts[i], IO_READ_SIZE) == FALSE){
+                freeBuffer(texts[i]);
+                texts[i] = NULL;
+                ended[i] = TRUE;
+                continue;
+            }
+            setOperation(&operations[count], IORING_OP_READ, fds[i], texts[i]->text + texts[i]->length, IO_READ_SIZE, (unsigned long) texts[i]->length);
+            files[count++] = i;
+        }
+        runOperations(ring, operations, count);
+        for (k = 0; k < count; k++) {
+            i = files[k];
+            if(operations[k].result > 0){
+                texts[i]->length += operations[k].result;
+                texts[i]->text[texts[i]->length] = NULL_TERM;
+            }
+            else{
+                if(operations[k].result < 0){
+                    freeBuffer(texts[i]);
+                    texts[i] = NULL;
+                }
+                ended[i] = TRUE;
+            }
+        }
+    } while (count > 0);
+
+    /*Closes all the files*/
+    count = 0;
+    for (i = 0; i < numOfFiles; i++)
+        if(fds[i] >= 0)
+            setOperation(&operations[count++], IORING_OP_CLOSE, fds[i], NULL, 0, 0);
+    runOperations(ring, operations, count);
+
+    free(operations);
+    free(fds);
+    free(ended);
+    free(files);
+    return TRUE;
+}
+
+static int replaceFilesRing(ioRing* ring, fileWrite* writes, int numOfWrites){
+    ioOperation* operations = (ioOperation*) malloc(numOfWrites * sizeof(ioOperation));
+    char** tempNames = (char**) calloc(numOfWrites, sizeof(char*));
+    int* fds = (int*) malloc(numOfWrites * sizeof(int));
+    long* written = (long*) malloc(numOfWrites * sizeof(long));
+    int* files = (int*) malloc(numOfWrites * sizeof(int));
+    int i, k, count = 0;
+
+    if(operations==NULL || tempNames==NULL || fds==NULL || written==NULL || files==NULL){
+        SAFE_FREE(operations)
+        SAFE_FREE(tempNames)
+        SAFE_FREE(fds)
+        SAFE_FREE(written)
+        SAFE_FREE(files)
+        return FALSE;
+    }
+
+    /*Opens (creates) the temporary files of all the files*/
+    for (i = 0; i < numOfWrites; i++) {
+        writes[i].result = FALSE;
+        fds[i] = -1;
+        written[i] = 0;
+        tempNames[i] = tempNameOf(writes[i].fileName);
+        if(tempNames[i] != NULL){
+            setOperation(&operations[count], IORING_OP_OPENAT, AT_FDCWD, tempNames[i], 0666, 0);
+            operations[count].flags = O_WRONLY | O_CREAT | O_TRUNC;
+            files[count++] = i;
+        }
+    }
+    runOperations(ring, operations, count);
+    for (k = 0; k < count; k++)
+        if(operations[k].result >= 0)
+            fds[files[k]] = operations[k].result;
+
+    /*Writes the content of all of them (a file that was not written whole in a round continues in the next)*/
+    do {
+        count = 0;
+        for (i = 0; i < numOfWrites; i++) {
+            if(fds[i] >= 0 && written[i] >= 0 && written[i] < writes[i].length){
+                setOperation(&operations[count], IORING_OP_WRITE, fds[i], writes[i].text + written[i],
+                             (unsigned int) (writes[i].length - written[i]), (unsigned long) written[i]);
+                files[count++] = i;
+            }
+        }
+        runOperations(ring, operations, count);
+        for (k = 0; k < count; k++)
+            written[files[k]] = (operations[k].result > 0) ? written[files[k]] + operations[k].result : -1;
+    } while (count > 0);
+
+    /*Closes them*/
+    count = 0;
+    for (i = 0; i < numOfWrites; i++) {
+        if(fds[i] >= 0){
+            setOperation(&operations[count], IORING_OP_CLOSE, fds[i], NULL, 0, 0);
+            files[count++] = i;
+        }
+    }
+    runOperations(ring, operations, count);
+    for (k = 0; k < count; k++)
+        if(operations[k].result < 0)
+            written[files[k]] = -1;
+
+    /*Renames every temporary file that was written whole to its file*/
+    count = 0;
+    for (i = 0; i < numOfWrites; i++) {
+        if(fds[i] >= 0 && written[i] == writes[i].length){
+            setOperation(&operations[count], IORING_OP_RENAMEAT, AT_FDCWD, tempNames[i], (unsigned int) AT_FDCWD, 0);
+            operations[count].newPath = writes[i].fileName;
+            files[count++] = i;
+        }
+    }
+    runOperations(ring, operations, count);
+    for (k = 0; k < count; k++)
+        if(operations[k].result == 0)
+            writes[files[k]].result = TRUE;
+
+    /*Removes the temporary files that are left*/
+    count = 0;
+    for (i = 0; i < numOfWrites; i++)
+        if(fds[i] >= 0 && writes[i].result == FALSE)
+            setOperation(&operations[count++], IORING_OP_UNLINKAT, AT_FDCWD, tempNames[i], 0, 0);
+    runOperations(ring, operations, count);
+
+    for (i = 0; i < numOfWrites; i++)
+        SAFE_FREE(tempNames[i])
+    free(operations);
+    free(tempNames);
+    free(fds);
+    free(written);
+    free(files);
+    return TRUE;
+}
+
+static int removeFilesRing(ioRing* ring, char** fileNames, int numOfFiles, int* results){
+    ioOperation* operations = (ioOperation*) malloc(numOfFiles * sizeof(ioOperation));
+    int i;
+
+    if(operations==NULL)
+        return FALSE;
+    for (i = 0; i < numOfFiles; i++)
+        setOperation(&operations[i], IORING_OP_UNLINKAT, AT_FDCWD, fileNames[i], 0, 0);
+    runOperations(ring, operations, numOfFiles);
+    for (i = 0; i < numOfFiles; i++)
+        results[i] = (operations[i].result == 0 || operations[i].result == -ENOENT) ? TRUE : FALSE;
+    free(operations);
+    return TRUE;
+}
+#endif
@@ -0,0 +1,86 @@
+#ifndef FILE_IO_H
+#define FILE_IO_H
+
+#include <stdio.h>
+#include "buffer.h"
+
+/*The file I/O of the assembler. The assembler itself only reads and builds text in memory, the files are read
+ *and written here, many at a time. When compiled with USE_IO_URING (Linux 5.12 or later), the operations of
+ *a batch of files (opening, reading, writing, renaming, closing) are submitted together to an io_uring ring,
+ *a few system calls for the whole batch. Every thread sets up its ring the first time it needs it and keeps it until it exits.
+ *Otherwise, or when the ring cannot be set up, stdio is used one file at a time.*/
+
+#define IO_BATCH_SIZE 32 /*The number of files whose sources are read (and outputs written) together*/
+#define IO_READ_SIZE 16384 /*The number of bytes a read asks for at a time*/
+#define IO_RING_ENTRIES 64 /*The number of operations submitted to the ring at a time*/
+#define IO_TEMP_EXTENSION ".tmp" /*Ends the name of the temporary file a new content of a file is written to*/
+#define IO_TEMP_NAME_EXTRA 44 /*The room for the id of the process and the number of a temporary file in its name*/
+
+/*A file to replace with new content*/
+typedef struct fileWrite{
+
+    /*The name of the file*/
+    const char* fileName;
+
+    /*The new content of the file*/
+    const char* text;
+    long length;
+
+    /*Set to 0 if the file was replaced, -1 otherwise*/
+    int result;
+
+}fileWrite;
+
+/**
+ * Reads a whole file into memory.
+ *
+ * @param fileName The name of the file.
+ * @return A buffer with the content of the file, or NULL if it cannot be read (or does not exist).
+ */
+buffer_ptr readWholeFile(const char* fileName);
+
+/**
+ * Reads an open stream (such as stdin) into memory until it ends.
+ *
+ * @param stream The stream.
+ * @return A buffer with what was read, or NULL if the stream cannot be read.
+ */
+buffer_ptr readWholeStream(FILE* stream);
+
+/**
+ * Finds the size of a file without opening it.
+ *
+ * @param fileName The name of the file.
+ * @return The size of the file in bytes, or 0 if it does not exist.
+ */
+long fileSize(const char* fileName);
+
+/**
+ * Reads several whole files into memory.
+ *
+ * @param fileNames The names of the files (a NULL name is not read).
+ * @param numOfFiles The number of files.
+ * @param texts Set to the content of every file, or NULL if it cannot be read (or does not exist).
+ */
+void readFiles(char** fileNames, int numOfFiles, buffer_ptr* texts);
+
+/**
+ * Replaces the content of several files. The content of a file is written to a temporary file next to it
+ * (its name with the id of the process, a number and IO_TEMP_EXTENSION) that is then renamed to the file,
+ * so the file is never seen half written, even when other threads or processes write it at the same time.
+ *
+ * @param writes The files and their content (the result of every file is set).
+ * @param numOfWrites The number of files.
+ */
+void replaceFiles(fileWrite* writes, int numOfWrites);
+
+/**
+ * Removes several files (a file that does not exist is ignored).
+ *
+ * @param fileNames The names of the files.
+ * @param numOfFiles The number of files.
+ * @param results Set to 0 for every file that is not there anymore, -1 for a file that cannot be removed.
+ */
+void removeFiles(char** fileNames, int numOfFiles, int* results);
+
+#endif /* FILE_IO_H */
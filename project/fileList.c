@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fileList.h"
+#include "fileIO.h"
+#include "diagnostics.h"
+#include "globals.h"
+#include "utils.h"
+
+/**
+ * Makes room for one more name at the end of a list (the list is doubled when it is full).
+ *
+ * @param list The list.
+ * @return 0 if there is room, -1 if memory could not be allocated.
+ */
+static int growFileList(fileList_ptr list);
+
+/**
+ * Keeps the text of a list file in a list (the names read from it point into it).
+ *
+ * @param list The list.
+ * @param text The text.
+ * @return 0 if the text was kept, -1 if memory could not be allocated (the text is freed).
+ */
+static int keepListText(fileList_ptr list, buffer_ptr text);
+
+fileList_ptr createFileList(void){
+    fileList_ptr list = (fileList_ptr) malloc(sizeof(fileList));
+    if(list==NULL){ report("Error: cannot allocate memory for a list of names\n");return NULL;}
+    list->names = (char**) malloc(FILE_LIST_INITIAL_SIZE * sizeof(char*));
+    if(list->names==NULL){
+        free(list);
+        report("Error: cannot allocate memory for a list of names\n");
+        return NULL;
+    }
+    list->count = 0;
+    list->size = FILE_LIST_INITIAL_SIZE;
+    list->texts = NULL;
+    list->numOfTexts = 0;
+    list->textsSize = 0;
+    return list;
+}
+
+int addToFileList(fileList_ptr list, char* name){
+    if(growFileList(list)==FALSE){
+        report("Error: cannot allocate memory to add %s to a list of names\n", name);
+        return FALSE;
+    }
+    list->names[list->count++] = name;
+    return TRUE;
+}
+
+int addFromListFile(fileList_ptr list, const char* listName, int byLines){
+    const char* separators = (byLines == TRUE) ? "\r\n" : " \t\r\n";
+    buffer_ptr text;
+    char* next;
+
+    text = (strcmp(listName, FILE_LIST_STDIN) == 0) ? readWholeStream(stdin) : readWholeFile(listName);
+    if(text==NULL){
+        report("Error: cannot read the %s %s\n", (byLines == TRUE) ? "file list" : "response file", listName);
+        return FALSE;
+    }
+    if(keepListText(list, text)==FALSE){
+        report("Error: cannot allocate memory for the names in %s\n", listName);
+        return FALSE;
+    }
+
+    /*Cuts the text into names in place (every name is ended with a null terminator)*/
+    next = text->text;
+    while (*(next += strspn(next, separators)) != NULL_TERM) {
+        char* name = next;
+        size_t length = strcspn(name, separators);
+
+        /*The next name starts after the separator that ends this one*/
+        next = name + length;
+        if(*next != NULL_TERM)
+            next++;
+        name[length] = NULL_TERM;
+
+        /*A line is a name without the white characters around it*/
+        if(byLines == TRUE){
+            name += strspn(name, " \t");
+            length = strlen(name);
+            while (length > 0 && (name[length - 1] == ' ' || name[length - 1] == '\t'))
+                name[--length] = NULL_TERM;
+        }
+        if(length > 0){
+            if(growFileList(list)==FALSE){
+                report("Error: cannot allocate memory for the names in %s\n", listName);
+                return FALSE;
+            }
+            list->names[list->count++] = name;
+        }
+    }
+    return TRUE;
+}
+
+void freeFileList(fileList_ptr list){
+    int i;
+
+    if(list==NULL)return;
+    for (i = 0; i < list->numOfTexts; i++)
+        freeBuffer(list->texts[i]);
+    SAFE_FREE(list->texts)
+    free(list->names);
+    free(list);
+}
+
+static int growFileList(fileList_ptr list){
+    char** newNames;
+
+    if(list->count < list->size)
+        return TRUE;
+    newNames = (char**) realloc(list->names, 2 * list->size * sizeof(char*));
+    if(newNames==NULL)
+        return FALSE;
+    list->names = newNames;
+    list->size *= 2;
+    return TRUE;
+}
+
+static int keepListText(fileList_ptr list, buffer_ptr text){
+    if(list->numOfTexts == list->textsSize){
+        int newSize = (list->textsSize > 0) ? 2 * list->textsSize : 4;
+        buffer_ptr* newTexts = (buffer_ptr*) realloc(list->texts, newSize * sizeof(buffer_ptr));
+        if(newTexts==NULL){
+            freeBuffer(text);
+            return FALSE;
+        }
+        list->texts = newTexts;
+        list->textsSize = newSize;
+    }
+    list->texts[list->numOfTexts++] = text;
+    return TRUE;
+}
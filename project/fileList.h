@@ -0,0 +1,61 @@
+#ifndef FILE_LIST_H
+#define FILE_LIST_H
+
+#include "buffer.h"
+
+#define FILE_LIST_INITIAL_SIZE 64 /*The initial number of names a list can hold*/
+#define FILE_LIST_STDIN "-" /*The name of a list that is read from the standard input*/
+
+/*A growing list of names (file names or command line arguments)*/
+typedef struct fileList * fileList_ptr;
+typedef struct fileList{
+
+    /*The names in the order they were added*/
+    char** names;
+    int count;
+    int size;
+
+    /*The texts of the list files that were read (the names read from them point into them)*/
+    buffer_ptr* texts;
+    int numOfTexts;
+    int textsSize;
+
+}fileList;
+
+/**
+ * Creates an empty list.
+ *
+ * @return A pointer to the new list, or NULL if memory could not be allocated (it is reported).
+ */
+fileList_ptr createFileList(void);
+
+/**
+ * Adds a name to the end of a list (the name is not copied).
+ *
+ * @param list The list.
+ * @param name The name.
+ * @return 0 if the name was added, -1 if memory could not be allocated (it is reported).
+ */
+int addToFileList(fileList_ptr list, char* name);
+
+/**
+ * Reads a list file and adds what is in it to the end of a list.
+ * A response file (@file) has arguments separated by white characters, the names in a
+ * file of --files-from are one in every line (white characters around them are ignored).
+ * Empty lines are skipped in both. A list file that cannot be read is reported by its name.
+ *
+ * @param list The list.
+ * @param listName The name of the list file, or FILE_LIST_STDIN to read the standard input.
+ * @param byLines Whether every line is a name (TRUE) or the names are separated by any white character (FALSE).
+ * @return 0 if the list file was read, -1 if it cannot be read (or memory could not be allocated).
+ */
+int addFromListFile(fileList_ptr list, const char* listName, int byLines);
+
+/**
+ * Frees a list and the texts of the list files read into it.
+ *
+ * @param list The list to free.
+ */
+void freeFileList(fileList_ptr list);
+
+#endif /* FILE_LIST_H */
@@ -1,355 +1,247 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include "firstPass.h"
-#include "globals.h"
-#include "utils.h"
-
-/**
- * Builds the first word for an instruction in the word table.
- *
- * @param sourceAdrArr The array representing the source addressing method.
- * @param destAdrArr The array representing the destination addressing method.
- * @param opcodeArr The array representing the opcode.
- * @param areArr The array representing the ARE (Absolute/Relative/External) attribute.
- * @param word A pointer to the word instruction structure.
- */
-static void buildFirstWordForIns(int sourceAdrArr[], int destAdrArr[], int opcodeArr[], int areArr[], wordIns_ptr word);
-
-/**
- * Builds a word for a numeric instruction in the word table.
- *
- * @param numInsArr The array representing the numeric instruction.
- * @param areArr The array representing the ARE (Absolute/Relative/External) attribute.
- * @param word A pointer to the word instruction structure.
- */
-static void buildWordForNum(int numInsArr[], int areArr[], wordIns_ptr word);
-
-/**
- * Builds a word for a register instruction in the word table.
- *
- * @param sourceReg The array representing the source register.
- * @param destReg The array representing the destination register.
- * @param areArr The array representing the ARE (Absolute/Relative/External) attribute.
- * @param word A pointer to the word instruction structure.
- */
-static void buildWordForReg(int sourceReg[], int destReg[], int areArr[], wordIns_ptr word);
-
-/**
- * Updates the addresses of directive words.
- *
- * @param wordDir_head The head pointer of the directives word table.
- * @param IC The final instruction counter.
- */
-static void addressingDirWords(wordDir_ptr wordDir_head,int IC);
-
-/**
- * Updates the symbol addresses defined in the instructions.
- *
- * @param wordIns_head The head pointer of the instructions word table.
- * @param symbol_head The head pointer of the symbol table.
- */
-static void addressingInsSymbols(wordIns_ptr wordIns_head,symbol_ptr symbol_head);
-
-/**
- * Updates the symbol addresses defined in the directives.
- *
- * @param wordDir_head The head pointer of the directives word table.
- * @param symbol_head The head pointer of the symbol table.
- */
-static void addressingDirSymbols(wordDir_ptr wordDir_head,symbol_ptr symbol_head);
-
-wordTable_ptr firstPass(st_ptr st_head,symbol_ptr symbol_head,char* outputName){
-
-    int  currentAddress = ADDRESS_START;    /*start at 100 always*/
-    int DC=0,IC=0;  /*instruction counter and data counter*/
-    st_ptr tempSt = st_head;
-    int srcAndDesRegisters=FALSE;   /*If the 2 operands are registers*/
-    int errorFlag  = FALSE;
-    wordTable_ptr wordTable_head  =  NULL;
-    wordDir_ptr wordDir_head  =  NULL;
-    wordIns_ptr wordIns_head  =  NULL;
-
-    /*if there was an error in the lexer, all freed, then it NULL*/
-    if(st_head==NULL)return NULL;
-
-    wordTable_head = (wordTable_ptr) malloc(sizeof(wordTable));
-    MALLOC_CHECK(wordTable_head)
-
-    /*tempSt - every st that analyzed a line*/
-    while (tempSt!=NULL){
-
-        /*If the line was an instruction*/
-        if(tempSt->sentenceType==instruction){
-
-            /*Auxiliary arrays to be used for conversion to binary*/
-            int sourceAdrArr[3]={0},destAdrArr[3]={0},opcodeArr[4]={0},areArr[2]={0};
-            int numInsArr[10]={0},srcReg[5]={0},desReg[5]={0};
-            wordIns_ptr word0;
-
-            /*Creates the first word (will always be created in the case of
-             * an instruction regardless of the number of operands) */
-            int numOfOperands  = tempSt->numOfOperands;
-            word0 = (wordIns_ptr) malloc(sizeof(wordIns));
-            MALLOC_CHECK(word0)
-            initializeInsWord(word0);
-
-            if(tempSt->hasLabel==TRUE){
-                word0->hasLabel=TRUE;
-                strcpy(word0->labelName,tempSt->label);
-            } else word0->hasLabel=FALSE;
-
-            /*Converts the addressing method of the operands according to the number of operands*/
-            switch (numOfOperands) {
-                case 1:
-                    decimalToBinary(destAdrArr,tempSt->destAdrMethod,3);
-                    break;
-                case 2:
-                    decimalToBinary(sourceAdrArr,tempSt->sourceAdrMethod,3);
-                    decimalToBinary(destAdrArr,tempSt->destAdrMethod,3);
-                    break;
-
-            }
-
-            /*Builds the first word and puts it in the instruction word table*/
-            decimalToBinary(opcodeArr,tempSt->opcode,4);
-            buildFirstWordForIns(sourceAdrArr,destAdrArr,opcodeArr,areArr,word0);
-            word0->address=currentAddress;
-            addToInsWordTable(&wordIns_head,word0);
-
-            currentAddress++;
-            IC++;
-            MEM_CHECK
-            resetInsArr(sourceAdrArr,destAdrArr,opcodeArr,areArr,numInsArr,srcReg,desReg);
-
-            /*If the number of operands is 2, will build a word for the source operand
-             * (because the destination operand will be built anyway later)*/
-            if(numOfOperands==2){
-                wordIns_ptr op2word;
-                op2word = (wordIns_ptr) malloc(sizeof(wordIns));
-                MALLOC_CHECK(op2word)
-                initializeInsWord(op2word);
-                op2word->isLabel = (tempSt->sourceOpType == label)?TRUE:FALSE;
-
-                /*Builds the word according to the type of operand*/
-                switch (tempSt->sourceOpType) {
-                    case number:
-                        decimalToBinary(numInsArr,tempSt->sourceOp,10);
-                        buildWordForNum(numInsArr,areArr,op2word);
-                        break;
-                    case reg:
-                        if(tempSt->destOpType==reg){
-                            srcAndDesRegisters=TRUE;
-                            decimalToBinary(desReg,tempSt->destOp,5);
-                            decimalToBinary(srcReg,tempSt->sourceOp,5);
-                        }
-                        else
-                            decimalToBinary(srcReg,tempSt->sourceOp,5);
-                        buildWordForReg(srcReg,desReg,areArr,op2word);
-                        break;
-                    case label:
-                        memset(op2word->binCode,0,sizeof(op2word->binCode));
-                        strcpy(op2word->labelName,tempSt->sourceOpLabel);
-                        break;
-                }
-
-                /*Finishes building the word and puts it in the word table of instructions*/
-                op2word->address=currentAddress;
-                addToInsWordTable(&wordIns_head,op2word);
-
-                currentAddress++;
-                IC++;
-                MEM_CHECK
-                resetInsArr(sourceAdrArr,destAdrArr,opcodeArr,areArr,numInsArr,srcReg,desReg);
-            }
-
-            /*Build the word for the destination operand*/
-            if((numOfOperands==1 || numOfOperands==2) && srcAndDesRegisters==FALSE){
-                wordIns_ptr op1word;
-                op1word = (wordIns_ptr) malloc(sizeof(wordIns));
-                MALLOC_CHECK(op1word)
-                initializeInsWord(op1word);
-                op1word->isLabel = (tempSt->destOpType == label)?TRUE:FALSE;
-
-                /*Builds the word according to the type of operand*/
-                switch (tempSt->destOpType) {
-                    case number:
-                        decimalToBinary(numInsArr,tempSt->destOp,10);
-                        buildWordForNum(numInsArr,areArr,op1word);
-                        break;
-                    case reg:
-                        decimalToBinary(desReg,tempSt->destOp,5);
-                        buildWordForReg(srcReg,desReg,areArr,op1word);
-                        break;
-                    case label:
-                        memset(op1word->binCode,0,sizeof(op1word->binCode));
-                        strcpy(op1word->labelName,tempSt->destOpLabel);
-                        break;
-                }
-
-                /*Finishes building the word and puts it in the word table of instructions*/
-                op1word->address=currentAddress;
-                addToInsWordTable(&wordIns_head,op1word);
-
-                currentAddress++;
-                IC++;
-                MEM_CHECK
-                resetInsArr(sourceAdrArr,destAdrArr,opcodeArr,areArr,numInsArr,srcReg,desReg);
-            }
-        }
-
-        /*If the line is a directive line and it is a DATA or STRING directive*/
-        if(tempSt->sentenceType==directive && (tempSt->directiveType==DATA || tempSt->directiveType==STRING)){
-
-            /*it it's DATA directive*/
-            if(tempSt->directiveType==DATA){
-
-                /*An auxiliary array for the binary representation of the numbers*/
-                int numArr[12]={0}, index=0;
-
-                while (tempSt->directive.Data.numArr[index]!=NUM_OUT_OF_RANGE)
-                {
-                    /*Creates a new word each time for a new number and puts it in the directive word table*/
-                    wordDir_ptr newWord = (wordDir_ptr) malloc(sizeof(wordDir));
-                    MALLOC_CHECK(newWord)
-                    initializeDirWord(newWord);
-                    if(tempSt->hasLabel==TRUE && index==0){
-                        newWord->hasLabel=TRUE;
-                        strcpy(newWord->labelName,tempSt->label);
-                    } else newWord->hasLabel=FALSE;
-                    decimalToBinary(numArr,tempSt->directive.Data.numArr[index],12);
-                    memcpy(newWord->binCode, numArr, 12 * sizeof(int));
-                    newWord->address=DC;
-                    addToDirWordTable(&wordDir_head,newWord);
-
-                    DC++;
-                    index++;
-                    MEM_CHECK
-                }
-            }
-
-            /*it it's STRING directive*/
-            if(tempSt->directiveType==STRING){
-
-                /*An auxiliary array for the binary representation of the chars*/
-                int charArr[12]={0},index=0;
-
-                /*Creates a word for the character 0 that comes at the end of each STRING*/
-                wordDir_ptr wordFor0str = (wordDir_ptr) malloc(sizeof(wordDir));
-                MALLOC_CHECK(wordFor0str)
-                initializeDirWord(wordFor0str);
-                wordFor0str->hasLabel = FALSE;
-
-                while (tempSt->directive.String.str[index]!=0)
-                {
-                    /*Creates a new word for each character in the string and converts its ascii code to binary
-                     *and puts it in the directive word table */
-                    wordDir_ptr newWord = (wordDir_ptr) malloc(sizeof(wordDir));
-                    MALLOC_CHECK(newWord)
-                    initializeDirWord(wordFor0str);
-                    if(tempSt->hasLabel==TRUE && index==0){
-                        newWord->hasLabel=TRUE;
-                        strcpy(newWord->labelName,tempSt->label);
-                    } else newWord->hasLabel=FALSE;
-                    charToBinary(tempSt->directive.String.str[index],charArr);
-                    memcpy(newWord->binCode, charArr, 12 * sizeof(int));
-                    newWord->address=DC;
-                    addToDirWordTable(&wordDir_head,newWord);
-
-                    DC++;
-                    index++;
-                    MEM_CHECK
-                }
-
-                /*Sets the word to the character 0, and puts it in the directive word table*/
-                memset(charArr,0,12* sizeof(int));
-                memcpy(wordFor0str->binCode, charArr, 12 * sizeof(int));
-                wordFor0str->address=DC;
-                addToDirWordTable(&wordDir_head,wordFor0str);
-
-                DC++;
-                MEM_CHECK
-            }
-        }
-        tempSt=tempSt->next;
-        srcAndDesRegisters=FALSE;
-    }
-
-    addressingDirWords(wordDir_head,IC);
-    addressingInsSymbols(wordIns_head,symbol_head);
-    addressingDirSymbols(wordDir_head,symbol_head);
-
-    if(errorFlag==TRUE){
-        freeInsTable(wordIns_head);
-        freeDirTable(wordDir_head);
-        return NULL;
-    }
-
-    /*Inserts a pointer to the top of the table of instructions
-     *and directive, and also their counter*/
-    wordTable_head->dir_head = wordDir_head;
-    wordTable_head->ins_head = wordIns_head;
-    wordTable_head->IC=IC;
-    wordTable_head->DC=DC;
-    return wordTable_head;
-}
-
-
-static void addressingInsSymbols(wordIns_ptr wordIns_head,symbol_ptr symbol_head){
-    wordIns_ptr tempIns=wordIns_head;
-    while (tempIns!=NULL){
-        if(tempIns->hasLabel==TRUE &&tempIns->isLabel==FALSE){
-            symbol_ptr tempSymbol = searchForSymbol(&symbol_head,tempIns->labelName);
-            /*it may be null when symbol is external*/
-            if(tempSymbol!=NULL)
-                tempSymbol->address = tempIns->address;
-        }
-        tempIns=tempIns->next;
-    }
-}
-
-static void addressingDirSymbols(wordDir_ptr wordDir_head,symbol_ptr symbol_head){
-    wordDir_ptr tempDir = wordDir_head;
-    while (tempDir!=NULL){
-        if(tempDir->hasLabel==TRUE){
-            symbol_ptr tempSymbol = searchForSymbol(&symbol_head,tempDir->labelName);
-            /*it may be null when symbol is external*/
-            if(tempSymbol!=NULL)
-                tempSymbol->address = tempDir->address;
-        }
-        tempDir=tempDir->next;
-    }
-}
-
-static void addressingDirWords(wordDir_ptr wordDir_head,int IC){
-    wordDir_ptr tempDir = wordDir_head;
-    while (tempDir!=NULL){
-        tempDir->address=IC+tempDir->address+ADDRESS_START;
-        tempDir=tempDir->next;
-    }
-}
-
-static void buildWordForNum(int numInsArr[],int areArr[],wordIns_ptr word){
-    /*builds the binary of the number: 2 bits - are, 10 bits binary representation of a number*/
-    memcpy(word->binCode, areArr, 2 * sizeof(int));
-    memcpy(word->binCode+2, numInsArr, 10 * sizeof(int));
-}
-static void buildWordForReg(int sourceReg[],int destReg[],int areArr[], wordIns_ptr word){
-    /*builds the binary of a register: bits 0-1 - are, bits 2-6 dest reg, bits 7-11 source reg*/
-    memcpy(word->binCode, areArr, 2 * sizeof(int));
-    memcpy(word->binCode+2, destReg, 5 * sizeof(int));
-    memcpy(word->binCode+7, sourceReg, 5 * sizeof(int));
-}
-
-static void buildFirstWordForIns(int sourceAdrArr[],int destAdrArr[],int opcodeArr[],int areArr[],wordIns_ptr word){
-    /*builds the binary of the first  instruction word: bits 0-1 - are, bits 2-4 and 9-11 for
-     *addressing method, bits 5-9 for opcode in binary*/
-    memcpy(word->binCode, areArr, 2 * sizeof(int));
-    memcpy(word->binCode + 2, destAdrArr, 3 * sizeof(int));
-    memcpy(word->binCode + 5, opcodeArr, 4 * sizeof(int));
-    memcpy(word->binCode + 9, sourceAdrArr, 3 * sizeof(int));
-}
-
-
-
-
+#include <stdio.h>
+#include <stdlib.h>
+#include "firstPass.h"
+#include "diagnostics.h"
+#include "globals.h"
+#include "utils.h"
+
+/**
+ * Builds the word of a number operand (its ARE is absolute).
+ *
+ * @param number The number.
+ * @return The word.
+ */
+static unsigned short buildWordForNum(int number);
+
+/**
+ * Builds the word of register operands (its ARE is absolute).
+ *
+ * @param sourceReg The source register number (0 if there is none).
+ * @param destReg The destination register number (0 if there is none).
+ * @return The word.
+ */
+static unsigned short buildWordForReg(int sourceReg, int destReg);
+
+/**
+ * Puts a word in the code or the data (a word past the memory is dropped, the memory error is reported anyway).
+ *
+ * @param words The code or the data.
+ * @param index The index of the word.
+ * @param word The word.
+ */
+static void addWord(unsigned short* words, int index, unsigned short word);
+
+/**
+ * Adds a fixup for a label operand word, and links it to the fixups of an external symbol.
+ *
+ * @param wordTable_head The word table.
+ * @param symbols The symbol table.
+ * @param index The index of the word in the code.
+ * @param name The name of the label.
+ */
+static void addFixup(wordTable_ptr wordTable_head, symbolTable_ptr symbols, int index, const char* name);
+
+/**
+ * Relocates the symbols defined at data words, the data comes after the code.
+ *
+ * @param symbols The symbol table.
+ * @param IC The instruction counter (the number of code words).
+ */
+static void relocateDataSymbols(symbolTable_ptr symbols,int IC);
+
+wordTable_ptr firstPass(stTable_ptr table,char* outputName,arena_ptr arena){
+
+    int DC=0,IC=0;  /*instruction counter and data counter*/
+    int i;
+    st_ptr tempSt;
+    int srcAndDesRegisters=FALSE;   /*If the 2 operands are registers*/
+    int errorFlag  = FALSE;
+    wordTable_ptr wordTable_head  =  NULL;
+    unsigned short* code;
+    unsigned short* data;
+
+    /*if there was an error in the lexer, all freed, then it NULL*/
+    if(table==NULL)return NULL;
+
+    /*The code and the data (and the fixups of the code) have room for the whole memory*/
+    wordTable_head = (wordTable_ptr) arenaAlloc(arena, sizeof(wordTable));
+    MALLOC_CHECK(wordTable_head)
+    code = wordTable_head->code = (unsigned short*) arenaAlloc(arena, CP_MEMORY * sizeof(unsigned short));
+    data = wordTable_head->data = (unsigned short*) arenaAlloc(arena, CP_MEMORY * sizeof(unsigned short));
+    wordTable_head->fixups = (fixup*) arenaAlloc(arena, CP_MEMORY * sizeof(fixup));
+    if(code==NULL || data==NULL || wordTable_head->fixups==NULL)
+        return NULL;
+    wordTable_head->numOfFixups = 0;
+
+    /*tempSt - every st that analyzed a line*/
+    for (i = 0; i < table->count; i++){
+        tempSt = &table->sentences[i];
+
+        /*If the line was an instruction*/
+        if(tempSt->sentenceType==instruction){
+
+            /*Creates the first word (will always be created in the case of
+             * an instruction regardless of the number of operands) */
+            int numOfOperands  = tempSt->numOfOperands;
+            if(tempSt->symbol!=NULL)
+                tempSt->symbol->address = ADDRESS_START + IC;
+
+            /*Builds the first word from the template of the instruction and the addressing methods of the operands
+             *(0 for an operand that is not given), and puts it in the code*/
+            addWord(code,IC,(unsigned short)(getInstructionInfo(tempSt->opcode)->firstWord |
+                    ENCODE_SOURCE_ADR(tempSt->source.adrMethod) | ENCODE_DEST_ADR(tempSt->dest.adrMethod)));
+            IC++;
+            MEM_CHECK
+
+            /*If the number of operands is 2, will build a word for the source operand
+             * (because the destination operand will be built anyway later)*/
+            if(numOfOperands==2){
+
+                /*Builds the word according to the type of operand*/
+                switch (tempSt->source.type) {
+                    case number:
+                        addWord(code,IC,buildWordForNum(tempSt->source.value));
+                        break;
+                    case reg:
+                        if(tempSt->dest.type==reg){
+                            srcAndDesRegisters=TRUE;
+                            addWord(code,IC,buildWordForReg(tempSt->source.value,tempSt->dest.value));
+                        }
+                        else
+                            addWord(code,IC,buildWordForReg(tempSt->source.value,0));
+                        break;
+                    case label:
+                        addWord(code,IC,0);
+                        addFixup(wordTable_head,table->symbols,IC,tempSt->source.label.start);
+                        break;
+                }
+                IC++;
+                MEM_CHECK
+            }
+
+            /*Build the word for the destination operand*/
+            if((numOfOperands==1 || numOfOperands==2) && srcAndDesRegisters==FALSE){
+
+                /*Builds the word according to the type of operand*/
+                switch (tempSt->dest.type) {
+                    case number:
+                        addWord(code,IC,buildWordForNum(tempSt->dest.value));
+                        break;
+                    case reg:
+                        addWord(code,IC,buildWordForReg(0,tempSt->dest.value));
+                        break;
+                    case label:
+                        addWord(code,IC,0);
+                        addFixup(wordTable_head,table->symbols,IC,tempSt->dest.label.start);
+                        break;
+                }
+                IC++;
+                MEM_CHECK
+            }
+        }
+
+        /*If the line is a directive line and it is a DATA or STRING directive*/
+        if(tempSt->sentenceType==directive && (tempSt->directiveType==DATA || tempSt->directiveType==STRING)){
+
+            /*The label is at the first word of the directive (the word of the character 0 of an empty STRING)*/
+            if(tempSt->symbol!=NULL){
+                tempSt->symbol->address = DC;
+                tempSt->symbol->flags |= SYMBOL_DATA;
+            }
+
+            /*it it's DATA directive*/
+            if(tempSt->directiveType==DATA){
+
+                int index=0;
+
+                while (index < tempSt->count)
+                {
+                    /*Puts a word for every number in the data*/
+                    addWord(data,DC,(unsigned short)(tempSt->directive.numbers[index] & WORD_MASK));
+
+                    DC++;
+                    index++;
+                    MEM_CHECK
+                }
+            }
+
+            /*it it's STRING directive*/
+            if(tempSt->directiveType==STRING){
+
+                int index=0;
+
+                while (index < tempSt->count)
+                {
+                    /*Puts a word for every character in the string with its ascii code*/
+                    addWord(data,DC,(unsigned char)tempSt->directive.str[index]);
+
+                    DC++;
+                    index++;
+                    MEM_CHECK
+                }
+
+                /*Puts the word of the character 0 that comes at the end of each STRING*/
+                addWord(data,DC,0);
+
+                DC++;
+                MEM_CHECK
+            }
+        }
+        srcAndDesRegisters=FALSE;
+    }
+
+    /*The words are freed with the arena*/
+    if(errorFlag==TRUE)
+        return NULL;
+
+    wordTable_head->IC=IC;
+    wordTable_head->DC=DC;
+    relocateDataSymbols(table->symbols,IC);
+    return wordTable_head;
+}
+
+static void addWord(unsigned short* words, int index, unsigned short word){
+    if(index < CP_MEMORY)
+        words[index] = word;
+}
+
+static void addFixup(wordTable_ptr wordTable_head, symbolTable_ptr symbols, int index, const char* name){
+    fixup_ptr newFixup;
+    symbol_ptr tempSymbol;
+
+    if(wordTable_head->numOfFixups >= CP_MEMORY)
+        return;
+    tempSymbol = searchForSymbol(symbols,name);
+    newFixup = &wordTable_head->fixups[wordTable_head->numOfFixups++];
+    newFixup->index = index;
+    newFixup->symbol = tempSymbol;
+    newFixup->name = name;
+    newFixup->nextOfSymbol = NULL;
+
+    /*The fixups of an external symbol are kept in a list, they are the lines of the extern file*/
+    if(tempSymbol!=NULL && (tempSymbol->flags & SYMBOL_EXTERNAL)){
+        if(tempSymbol->lastFixup==NULL)
+            tempSymbol->firstFixup = newFixup;
+        else
+            tempSymbol->lastFixup->nextOfSymbol = newFixup;
+        tempSymbol->lastFixup = newFixup;
+    }
+}
+
+static void relocateDataSymbols(symbolTable_ptr symbols,int IC){
+    symbol_ptr tempSymbol;
+
+    /*The data symbols got their index in the data, now that the size of the code is known they get their address*/
+    for (tempSymbol = symbols->head; tempSymbol != NULL; tempSymbol = tempSymbol->next)
+        if(tempSymbol->flags & SYMBOL_DATA)
+            tempSymbol->address += ADDRESS_START + IC;
+}
+
+static unsigned short buildWordForNum(int number){
+    /*builds the binary of the number: 2 bits - are, 10 bits binary representation of a number*/
+    return (unsigned short)(ENCODE_ARE(ARE_ABSOLUTE) | ENCODE_VALUE(number));
+}
+static unsigned short buildWordForReg(int sourceReg,int destReg){
+    /*builds the binary of a register: bits 0-1 - are, bits 2-6 dest reg, bits 7-11 source reg*/
+    return (unsigned short)(ENCODE_ARE(ARE_ABSOLUTE) | ENCODE_DEST_REG(destReg) | ENCODE_SOURCE_REG(sourceReg));
+}
@@ -1,618 +1,929 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-
-#include "lexer.h"
-#include "lexer_utils.h"
-#include "globals.h"
-#include "preprocess.h"
-#include "utils.h"
-
-/**
- * Gets the type of the operand (number/label/register).
- *
- * @param operand The operand to analyze.
- * @param st The st node of the line.
- * @param op_method The operand  method (source operand or destination operand).
- * @param currentLine The current line number.
- * @param filename The name of the source file.
- * @param errorFlag A pointer to the error flag.
- * @return 0 if the operation label is valid, -1 otherwise.
- * */
-static int getOperandType(char* operand,st_ptr st,int op_method,int currentLine,const char* filename,int* errorFlag);
-
-
-/**
- * Analyzes the operands in the given line.
- *
- * @param line The given line.
- * @param currentLine The current line number (for error message).
- * @param filename The name of the source file (for error message).
- * @param st The st node of the line.
- * @param errorFlag A pointer to the error flag.
- * @return 0 if the operation label is valid, -1 otherwise.
- */
-static int operandsAnalyze(char* line,int currentLine,const char* filename,st_ptr st,int* errorFlag);
-
-/**
- * Analyzes the string directive in the given line.
- *
- * @param line The given line.
- * @param currentLine The current line number (for error message).
- * @param filename The name of the source file (for error message).
- * @param currentLine The current line number.
- * @param filename The name of the source file.
- * @param st The st node of the line.
- * @param errorFlag A pointer to the error flag.
- * @return 0 if the operation label is valid, -1 otherwise.
- * */
-static int stringDirAnalyze(const char* line,const char* label,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag);
-
-/**
- * Analyzes the data directive in the given line.
- *
- * @param line The given line.
- * @param label The label of the directive (if exists).
- * @param index A pointer to the index in the line.
- * @param currentLine The current line number (for error message).
- * @param filename The name of the source file (for error message).
- * @param st The st node of the line.
- * @param errorFlag A pointer to the error flag.
- * @return 0 if the operation label is valid, -1 otherwise.
- */
-static int dataDirAnalyze(const char* line,const char* label,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag);
-
-/**
- * Analyzes the external labels in the given line.
- *
- * @param definedLabel A label that may be defined before the command
- * @param line The given line.
- * @param symbol_head The head of the symbol table.
- * @param currentLine The current line number.
- * @param filename The name of the source file.
- * @param errorFlag A pointer to the error flag.
- * @return 0 if the operation label is valid, -1 otherwise.
- */
-static int extLabelsAnalyze(const char* definedLabel, const char* line, symbol_ptr* symbol_head, int currentLine, const char* filename, int* errorFlag);
-
-/**
- * Analyzes the entry label in the given line.
- *
- * @param label The label to analyze.
- * @param symbol_head The head of the symbol table.
- * @param currentLine The current line number.
- * @param filename The name of the source file.
- * @param errorFlag A pointer to the error flag.
- * @return 0 if the operation label is valid, -1 otherwise.
- */
-static int entryLabelAnalyze(char* label, symbol_ptr* symbol_head, int currentLine, const char* filename, int* errorFlag);
-
-st_ptr lexer(char *filename) {
-
-    FILE *amFile = fopen(filename, "r");
-    char line[MAX_LENGTH_LINE];
-    char lineCopy[MAX_LENGTH_LINE];
-    char *delim = " \t\n";
-    int currentLine = 1,lineError=FALSE;
-    symbol_ptr symbol_head = NULL;
-    st_ptr st_head = NULL;
-    if (amFile == NULL)
-        return NULL;
-
-    while (fgets(line, MAX_LENGTH_LINE_EXTENDED, amFile)) {
-
-        char* label;
-        char definedLabel[MAX_LABEL_SIZE]={NULL_TERM};
-        int errorFlag = FALSE, labelFlag=FALSE,dirType,instType;
-        int* p_errorFlag = &errorFlag;
-        st_ptr st;
-        symbol_ptr newSymbol;
-        st = (st_ptr) malloc(sizeof(sentenceTree));
-
-        MALLOC_CHECK(st)
-        initializeSt(st);
-
-        /*Checks if the line length is greater than the allowed length*/
-        if (strlen(line) > MAX_LENGTH_LINE) {
-            printf("Error: line %d is too long in file %s\n", currentLine, filename);
-            currentLine++;
-            errorFlag = TRUE;
-        }
-
-        if (errorFlag == FALSE) {
-            strcpy(lineCopy, line);
-            label = strtok(lineCopy, delim);
-
-            /*In case there's a label*/
-            if (label[strlen(label) - 1] == ':'){
-                label[strlen(label) - 1] = '\0';
-
-                /*Checks if the symbol is valid, if so, inserts it into the symbol table*/
-                if(isValidLabel(label, symbol_head, filename, currentLine,p_errorFlag,relocatable)==TRUE){
-                    newSymbol  = createNewSymbol(label,relocatable);
-                    addToSymbolTable(&symbol_head,newSymbol);
-                    strcpy(st->label,label);
-
-                    strcpy(definedLabel,label);
-                    labelFlag=TRUE;
-                    st->hasLabel=TRUE;
-
-                    label = strtok(NULL, delim);
-                    if(label==NULL){
-                        printf("Error: missing command in line %d in %s\n", currentLine,filename);
-                        errorFlag=TRUE;
-                    }
-                }
-            }
-
-            /*Checks if that label is a directive*/
-            if((dirType = isDirectiveLabel(label))!=non_dir && errorFlag == FALSE){
-                st->sentenceType =  directive;
-                st->directiveType =  dirType;
-                label = strtok(NULL, delim);
-
-                /*If this is a DATA directive, will analyze the line*/
-                if(dirType==DATA){
-                    int lastValidChar;
-                    int tempIndex = findFirstNumber(line,labelFlag,st);
-                    lastValidChar = dataDirAnalyze(line,label,&tempIndex,currentLine,filename,st,p_errorFlag);
-                    skipWhiteChars(line,&tempIndex);
-                    if(!isdigit(lastValidChar) && errorFlag==FALSE){
-                        printf("Error: Extraneous text after end of command in line %d in %s\n", currentLine,filename);
-                        errorFlag=TRUE;
-                    }
-                }
-
-                /*If this is a STRING directive, will analyze the line*/
-                if(dirType==STRING){
-                    int tempIndex = findIndexFromLine(line,APOSTROPHES);
-                    stringDirAnalyze(line,label,&tempIndex,currentLine,filename,st,&errorFlag);
-                    skipWhiteChars(line,&tempIndex);
-                    if(line[tempIndex]!=END_OF_LINE && errorFlag==FALSE){
-                        printf("Error: Extraneous text after end of command in line %d in %s\n", currentLine,filename);
-                        errorFlag=TRUE;
-                    }
-                }
-
-                /*If this is a ENTRY/EXTERN directive, will analyze the line*/
-                if(dirType == ENTRY || dirType == EXTERN){
-                    int type = (dirType==ENTRY)?entry:external;
-                    if(labelFlag == TRUE)
-                        printf("Warning: The label %s has been defined in line %d  in %s  before .entry/.extern directive\n",definedLabel,currentLine,filename);
-                    switch (type) {
-                        case entry:
-                            entryLabelAnalyze(label,&symbol_head,currentLine,filename,p_errorFlag);
-                            break;
-                        case external:
-                            extLabelsAnalyze(definedLabel,line,&symbol_head,currentLine,filename,p_errorFlag);
-                            break;
-                    }
-                }
-            }
-
-            /*In case there's a label*/
-            else if((instType = isInstructionLabel(label))!=non_op && errorFlag == FALSE){
-                st->sentenceType =  instruction;
-                st->opcode =  instType;
-                st->numOfOperands = getNumOfOperands(instType);
-                label = strtok(NULL, "");
-                operandsAnalyze(label,currentLine,filename,st,p_errorFlag);
-            }
-
-            /*If no directive or instruction was detected*/
-            else {
-                if(errorFlag==FALSE){
-                    printf("Error: Undefined command name in line %d in %s\n", currentLine,filename);
-                    errorFlag=TRUE;
-                }
-            }
-        }
-        /*Checks at the end of each line whether there was an error in the line,
-             * if so it will indicate that there was an error in some line*/
-        if(errorFlag==FALSE)
-            addToStTable(&st_head,st);
-        else
-        {
-            if(st!=NULL)free(st);
-            lineError=TRUE;
-        }
-        currentLine++;
-        labelFlag=FALSE;
-        errorFlag=FALSE;
-    }
-
-    fclose(amFile);
-
-    /*If there were no errors in any line*/
-    if(lineError==FALSE){
-        st_head->symbol_head  = symbol_head;
-        return st_head;
-    }
-
-    /*if there was an error, frees the tables*/
-    else{
-        freeStTable(st_head);
-        freeSymbolTable(symbol_head);
-        return NULL;
-    }
-}
-
-static int getOperandType(char* operand,st_ptr st,int op_method,int currentLine,const char* filename,int* errorFlag){
-    int validOperand = FALSE, type, opNum=0;
-
-    /*If the operand may be a register*/
-    if(operand[0]=='@' && strlen(operand)==3) {
-
-        /*Removes the @ character and leaves the rest of the characters*/
-        operand[0] = operand[1];
-        operand[1] = operand[2];
-        operand[2] = '\0';
-
-        /*Checks if the label is a register*/
-        if (isRegisterLabel(operand) != non_reg) {
-            type = reg;
-            opNum = isRegisterLabel(operand);
-            validOperand = TRUE;
-        }
-        else{
-            printf("Error: invalid register name in line %d in %s\n",currentLine,filename);
-            SET_ERROR
-        }
-    }
-
-    /*Checks if the operand is a valid number*/
-    if(isValidOpNumber(operand) == TRUE && validOperand == FALSE){
-        type=number;
-        opNum=strtol(operand,NULL,10);
-        validOperand=TRUE;
-    }
-
-    /*Checks if the operand is a valid label*/
-    if(isValidOpLabel(operand)==TRUE && validOperand==FALSE){
-        type=label;
-        if(op_method==source)
-            strcpy(st->sourceOpLabel,operand);
-        else
-            strcpy(st->destOpLabel,operand);
-        validOperand=TRUE;
-    }
-
-    /*If not any of them - the operand is not valid*/
-    if(validOperand==FALSE){
-        printf("Error: invalid operand given in line %d in %s\n", currentLine, filename);
-        SET_ERROR
-    }
-    else{
-        switch (op_method) {
-            case source:
-                st->sourceOpType = type;
-                if(type!= label)
-                    st->sourceOp = opNum;
-                break;
-            case destination:
-                st->destOpType = type;
-                if(type!= label)
-                    st->destOp = opNum;
-                break;
-        }
-    }
-    return TRUE;
-}
-
-static int operandsAnalyze(char* line,int currentLine,const char* filename,st_ptr st,int* errorFlag){
-    int numOfOperands = st->numOfOperands, opCode =  st->opcode;
-    char op1[MAX_LENGTH_LINE]={'\0'},op2[MAX_LENGTH_LINE]={'\0'};
-    char lastValidChar=ZERO_NUMBER,currentChar;
-    int  index=0,op1Index=0,op2Index=0,whiteCounts=0,hasComma=FALSE,opCount = 1;
-    int  hasOp1=FALSE,hasOp2=FALSE;
-
-    if(line!=NULL){
-        skipWhiteChars(line,&index);
-        while (1){
-
-            currentChar = line[index];
-
-            if (lastValidChar == COMMA && currentChar == COMMA) {
-                printf("Error: multiple commas in line %d in %s\n", currentLine, filename);
-                SET_ERROR
-            }
-
-            if (lastValidChar != COMMA && currentChar != COMMA &&  whiteCounts>0) {
-                printf("Error: missing comma in line %d in %s\n", currentLine, filename);
-                SET_ERROR
-            }
-
-            /*will enter data according to the appropriate operand (source/destination)*/
-            if(currentChar!=COMMA && opCount<3){
-                if(hasComma==FALSE){
-                    op1[op1Index]  = currentChar;
-                    op1Index++;
-                    lastValidChar = currentChar;
-                    hasOp1=TRUE;
-                }
-                else{
-                    op2[op2Index]  = currentChar;
-                    op2Index++;
-                    lastValidChar = currentChar;
-                    hasOp2=TRUE;
-                }
-            }
-            else{
-                hasComma=TRUE;
-                lastValidChar=COMMA;
-                opCount++;
-            }
-
-            index++;
-            whiteCounts = skipWhiteChars(line, &index);
-
-            if(line[index]==END_OF_LINE){
-                if(lastValidChar!=op1[op1Index-1] && lastValidChar!=op2[op2Index-1] ){
-                    printf("Error: Extraneous text after end of command in line %d in %s\n", currentLine,filename);
-                    SET_ERROR
-                }
-                break;
-            }
-        }
-    }
-    else{
-        if(numOfOperands==0)
-            return TRUE;
-        printf("Error: operand not given in line %d in %s\n", currentLine, filename);
-        SET_ERROR
-    }
-
-    /*too many operands error*/
-    if((numOfOperands==0 && hasOp1==TRUE) || (numOfOperands==1 && hasOp2==TRUE)){
-        printf("Error: too many operands given in line %d in %s\n", currentLine, filename);
-        SET_ERROR
-    }
-
-    /*too few operands error*/
-    if((numOfOperands==1 && hasOp1==FALSE) || (numOfOperands==2 && hasOp2==FALSE)){
-        printf("Error: too few operands given in line %d in %s\n", currentLine, filename);
-        SET_ERROR
-    }
-
-    /*operand/s isn't valid*/
-    if(numOfOperands==1){
-        if(hasOp1==TRUE && getOperandType(op1,st,destination,currentLine,filename,errorFlag)==FALSE){
-            SET_ERROR
-        }
-    }
-    if(numOfOperands==2){
-        if((hasOp1==TRUE && getOperandType(op1,st,source,currentLine,filename,errorFlag)==FALSE) ||
-           (hasOp2==TRUE && getOperandType(op2,st,destination,currentLine,filename,errorFlag)==FALSE)){
-            SET_ERROR
-        }
-    }
-    if(st->destOpType == number  && !(opCode==cmp||opCode==prn||opCode==rts||opCode==stop)){
-        printf("Error: a number cannot be a destination operand in line %d in %s\n", currentLine, filename);
-        SET_ERROR
-    }
-    if((st->sourceOpType == number || st->sourceOpType == reg) && opCode==lea){
-        printf("Error: a number/register cannot be a source operand in line %d in %s\n", currentLine, filename);
-        SET_ERROR
-    }
-    addressingAnalyze(st);
-    return TRUE;
-}
-
-static int stringDirAnalyze(const char* line,const char* label,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag){
-    int strIndex = 1;
-
-    /*If a string is not defined or does not start with apostrophes*/
-    if(label==NULL || (*index)==0 || label[0]!=APOSTROPHES ){
-        printf("Error: a string has been not defined / defined correctly in line %d in %s\n",currentLine,filename);
-        SET_ERROR
-    }
-
-    (*index)++;
-
-    while (line[(*index)]!=APOSTROPHES){
-
-        if(line[(*index)]==END_OF_LINE){
-            printf("Error: missing apostrophes for the string in line %d in %s\n",currentLine,filename);
-            SET_ERROR
-        }
-
-        else{
-            st->directive.String.str[strIndex-1] = line[(*index)];
-            strIndex++;
-            (*index)++;
-        }
-
-    }
-
-    /*If the string is correct, insert the character 0 at the end*/
-    if((*errorFlag)==FALSE){
-        st->directive.String.str[strIndex-1] = 0;
-        (*index)+=1;/*PROMOTE AFTER "*/
-    }
-
-    return TRUE;
-}
-
-static int dataDirAnalyze(const char* line,const char* label,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag) {
-    int numArrIndex = 0, stNumArr = 0, hasSign = FALSE;
-    char numberArr[MAX_LABEL_SIZE]={0};
-    char currentChar, lastValidChar = '0';
-    int whiteCounts = 0;
-
-    /*If the label does not start with a sign (minus/plus) or number*/
-    if (label == NULL || (!isdigit(label[0]) && label[0] != MINUS && label[0] != PLUS) || (*index) == 0) {
-        printf("Error: missing/invalid parameter in line %d in %s\n", currentLine, filename);
-        SET_ERROR
-    }
-
-    while (1) {
-
-        currentChar = line[*index];
-
-        if (currentChar == PLUS || currentChar == MINUS) {
-            if (hasSign == TRUE) {
-                printf("Error: multiple signs in line %d in %s\n", currentLine, filename);
-                SET_ERROR
-            }
-            hasSign = TRUE;
-        }
-
-        if (lastValidChar == COMMA && currentChar == COMMA) {
-            printf("Error: multiple commas in line %d in %s\n", currentLine, filename);
-            SET_ERROR
-        }
-
-        if (lastValidChar != COMMA && currentChar != COMMA &&  whiteCounts>0) {
-            printf("Error: missing comma in line %d in %s\n", currentLine, filename);
-            SET_ERROR
-        }
-
-        /*If the character of the label is valid, will be inserted into the array*/
-        if (isdigit(currentChar) || currentChar == MINUS || currentChar == PLUS) {
-            if (currentChar != PLUS) {
-                hasSign = (currentChar == MINUS) ? TRUE : FALSE;
-                numberArr[numArrIndex] = currentChar;
-                lastValidChar = currentChar;
-                numArrIndex++;
-            }
-        }
-
-        /*Reaching the end of sub input*/
-        if (!isdigit(currentChar) &&  currentChar != MINUS && currentChar!=PLUS) {
-            if (currentChar != COMMA) {
-                printf("Error: invalid parameter in line %d in %s\n", currentLine, filename);
-                SET_ERROR
-            } else {
-                int number = 0;
-                number = strtol(numberArr, NULL, 10);
-                if (number <= MAX_VALID_DIR_NUMBER && number >= MIN_VALID_DIR_NUMBER) {
-                    st->directive.Data.numArr[stNumArr] = strtol(numberArr, NULL, 10);
-                    memset(numberArr, 0, sizeof(numberArr));
-                    numArrIndex = 0;
-                    stNumArr++;
-                    hasSign = FALSE;
-                    lastValidChar = currentChar;
-                } else {
-                    printf("Error: the number %d in line %d in %s is outside the allowed range \n", number, currentLine,filename);
-                    SET_ERROR
-                }
-            }
-        }
-
-        (*index)++;
-        whiteCounts = skipWhiteChars(line, index);
-
-        /*Reaching the end of a line and handling correct/incorrect input*/
-        if(line[*index]==END_OF_LINE){
-            if(isdigit(lastValidChar)){
-                int number = 0;
-                number = strtol(numberArr, NULL, 10);
-                if(number==0 && numberArr[0]!=ZERO_NUMBER){
-                    printf("Error: invalid parameter in line %d in %s\n", currentLine, filename);
-                    SET_ERROR
-                }
-                else if(number <= MAX_VALID_DIR_NUMBER && number >= MIN_VALID_DIR_NUMBER)
-                    st->directive.Data.numArr[stNumArr] = strtol(numberArr, NULL, 10);
-                else{
-                    printf("Error: the number %d in line %d in %s is outside the allowed range \n", number, currentLine,filename);
-                    SET_ERROR
-                }
-            }
-            break;
-        }
-    }
-    return lastValidChar;
-}
-
-static int extLabelsAnalyze(const char* definedLabel,const char* line, symbol_ptr* symbol_head, int currentLine, const char* filename, int* errorFlag) {
-    int index = 0;
-    int labelIndex = 0, whiteCounts = 0;
-    char symbolName[MAX_LENGTH_LINE] = { NULL_TERM };
-    char currentChar, lastValidChar = NULL_TERM;
-
-    skipWhiteChars(line, &index);
-    index+= strlen(definedLabel)+1;
-    skipWhiteChars(line, &index);
-    index += strlen(".extern");
-    skipWhiteChars(line, &index);
-
-    /*If there are no parameters*/
-    if (line[index] == END_OF_LINE) {
-        printf("Error: missing parameters in line %d in %s\n", currentLine, filename);
-        *errorFlag = TRUE;
-    }
-
-    while (1) {
-        currentChar = line[index];
-
-        if (lastValidChar == COMMA && currentChar == COMMA) {
-            printf("Error: multiple commas in line %d in %s\n", currentLine, filename);
-            *errorFlag = TRUE;
-        }
-
-        if (lastValidChar != COMMA && currentChar != COMMA && whiteCounts > 0) {
-            printf("Error: missing comma in line %d in %s\n", currentLine, filename);
-            *errorFlag = TRUE;
-        }
-
-        /*Reaching a comma, ending input and testing*/
-        if (line[index] == COMMA) {
-            if (isValidLabel(symbolName, *symbol_head, filename, currentLine, errorFlag, external) == TRUE) {
-                symbol_ptr newSymbol = createNewSymbol(symbolName, external);
-                addToSymbolTable(symbol_head, newSymbol);
-                memset(symbolName, NULL_TERM, sizeof(label));
-                labelIndex = 0;
-            }
-        } else {
-            symbolName[labelIndex] = line[index];
-            labelIndex++;
-        }
-
-        lastValidChar = line[index];
-        index++;
-        whiteCounts = skipWhiteChars(line, &index);
-
-        /*Handling valid/invalid input at the end of a line*/
-        if (line[index] == END_OF_LINE) {
-            if (symbolName[0] != NULL_TERM) {
-                if (isValidLabel(symbolName, *symbol_head, filename, currentLine, errorFlag, external) == TRUE) {
-                    symbol_ptr newSymbol = createNewSymbol(symbolName, external);
-                    addToSymbolTable(symbol_head, newSymbol);
-                }
-            } else if (currentChar == COMMA) {
-                printf("Error: missing parameters in line %d in %s\n", currentLine, filename);
-                *errorFlag = TRUE;
-            }
-
-            break;
-        }
-    }
-    return TRUE;
-}
-
-static int entryLabelAnalyze(char* label, symbol_ptr* symbol_head, int currentLine, const char* filename, int* errorFlag) {
-    symbol_ptr tempSymbol, newSymbol;
-    char* delim = " \t\n";
-
-    /*Only one label is allowed, so straight away will check it*/
-    if (isValidLabel(label, *symbol_head, filename, currentLine, errorFlag, entry) == TRUE) {
-        tempSymbol = searchForSymbol(symbol_head, label);
-        if (tempSymbol != NULL)
-            tempSymbol->type = entry;
-        else {
-            newSymbol = createNewSymbol(label, entry);
-            addToSymbolTable(symbol_head, newSymbol);
-        }
-    }
-
-    label = strtok(NULL, delim);
-
-    /*Checks for extra text at the end of a line*/
-    if (label != NULL && (*errorFlag) == FALSE) {
-        printf("Error: Extraneous text after end of command in line %d in %s\n", currentLine, filename);
-        *errorFlag = TRUE;
-    }
-
-    return TRUE;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "lexer.h"
+#include "lexer_utils.h"
+#include "globals.h"
+#include "preprocess.h"
+#include "utils.h"
+#include "diagnostics.h"
+#include "threadPool.h"
+
+/*The addressing method of every operand type, indexed by operandType*/
+static const unsigned char operandAddressing[] = {immediate, direct, reg_direct};
+
+/*A label definition (a label before a command, .extern or .entry) found in a line.
+ *It is checked against the symbol table only when the chunks are merged, in the order of the lines*/
+typedef struct symbolEvent{
+
+    /*The name of the label*/
+    char name[MAX_LABEL_SIZE + 1];
+
+    /*The type of the definition (relocatable/external/entry)*/
+    int type;
+
+    /*The length of the diagnostics of the chunk when the label was found*/
+    long textOffset;
+
+    /*For .entry, whether there is extra text after the label*/
+    int extraneousText;
+
+}symbolEvent;
+
+/*The result of lexing one line of a chunk*/
+typedef struct lineResult{
+
+    /*The line number of the line (for error messages)*/
+    int currentLine;
+
+    /*The st node of the line, and whether it is kept (FALSE if there was an error in the line)*/
+    sentenceTree st;
+    int hasSentence;
+
+    /*The length of the diagnostics of the chunk at the end of the line*/
+    long textEnd;
+
+    /*The index of the first label definition of the line, and how many there are*/
+    int firstEvent;
+    int numOfEvents;
+
+}lineResult;
+
+/*A part of the am text made of whole lines, lexed on its own (possibly by another thread)*/
+typedef struct lexChunk * chunk_ptr;
+typedef struct lexChunk{
+
+    /*The am text and the part of it that belongs to the chunk*/
+    buffer_ptr amText;
+    long start;
+    long end;
+
+    /*The line number of the first line of the chunk*/
+    int firstLine;
+
+    /*The name of the am file (for error messages)*/
+    const char* filename;
+
+    /*The messages reported while lexing the chunk*/
+    buffer_ptr diagnostics;
+
+    /*The arena the st nodes of the chunk are allocated from*/
+    arena_ptr arena;
+
+    /*The results of the lines of the chunk*/
+    lineResult* lines;
+    int numOfLines;
+    int linesSize;
+
+    /*The label definitions found in the lines of the chunk*/
+    symbolEvent* events;
+    int numOfEvents;
+    int eventsSize;
+
+    /*Whether memory could not be allocated while lexing the chunk*/
+    int failed;
+
+}lexChunk;
+
+/**
+ * Lexes all the lines of a chunk (a task of the thread pool).
+ *
+ * @param arg The chunk to lex.
+ */
+static void lexChunkTask(void* arg);
+
+/**
+ * Lexes one line of a chunk, the label definitions are only recorded in the chunk.
+ *
+ * @param chunk The chunk of the line.
+ * @param line The line to lex.
+ * @param currentLine A pointer to the current line number (advanced an extra time for a line that is too long).
+ * @return 0 if the line was lexed, -1 if memory could not be allocated.
+ */
+static int lexLine(chunk_ptr chunk, char* line, int* currentLine);
+
+/**
+ * Records a label definition of the current line of a chunk.
+ *
+ * @param chunk The chunk of the line.
+ * @param name The label.
+ * @param type The type of the definition (relocatable/external/entry).
+ * @param extraneousText For .entry, whether there is extra text after the label.
+ * @return 0 if the definition was recorded, -1 if memory could not be allocated.
+ */
+static int addSymbolEvent(chunk_ptr chunk, span name, int type, int extraneousText);
+
+/**
+ * Copies the labels and the directive of a st node from the line into the arena,
+ * so the st node can be kept after the line is gone.
+ *
+ * @param st The st node of a line without errors.
+ * @param arena The arena to copy to.
+ * @return 0 if the st node was copied, -1 if memory could not be allocated.
+ */
+static int keepSentence(st_ptr st, arena_ptr arena);
+
+/**
+ * Merges the chunks in the order of the lines: prints their messages, checks the label definitions
+ * against the symbol table and adds the st nodes of the lines without errors to the st table.
+ *
+ * @param chunks The chunks.
+ * @param numOfChunks The number of chunks.
+ * @param table The st table (its array has room for all the lines).
+ * @return 0 if there were no errors in any line, -1 otherwise.
+ */
+static int mergeChunks(chunk_ptr chunks, int numOfChunks, stTable_ptr table);
+
+/**
+ * Checks a label definition against the symbol table and inserts it.
+ *
+ * @param event The label definition.
+ * @param symbols The symbol table.
+ * @param filename The name of the source file (for error messages).
+ * @param currentLine The line number of the definition (for error messages).
+ * @param errorFlag A pointer to the error flag of the line.
+ * @param defined A pointer to store the symbol of a label defined before a command in.
+ * @return 0 if the label was defined, -1 otherwise.
+ */
+static int applySymbolEvent(symbolEvent* event, symbolTable_ptr symbols, const char* filename, int currentLine, int* errorFlag, symbol_ptr* defined);
+
+/**
+ * Checks that every label declared as entry is defined in the file.
+ *
+ * @param symbols The symbol table.
+ * @param filename The name of the source file (for error messages).
+ * @return 0 if all the entry labels are defined, -1 otherwise.
+ */
+static int checkEntryLabels(symbolTable_ptr symbols, const char* filename);
+
+/**
+ * Counts the line numbers that a part of the am text takes (a line that is too long takes two).
+ *
+ * @param text The part of the text (made of whole lines).
+ * @param length The length of the part.
+ * @return The number of line numbers.
+ */
+static int countLineNumbers(const char* text, long length);
+
+/**
+ * Gets the type of the operand (number/label/register).
+ *
+ * @param operand The span of the operand to analyze.
+ * @param st The st node of the line.
+ * @param op_method The operand  method (source operand or destination operand).
+ * @param currentLine The current line number.
+ * @param filename The name of the source file.
+ * @param errorFlag A pointer to the error flag.
+ * @return 0 if the operation label is valid, -1 otherwise.
+ * */
+static int getOperandType(span operand,st_ptr st,int op_method,int currentLine,const char* filename,int* errorFlag);
+
+
+/**
+ * Analyzes the operands in the given line.
+ *
+ * @param scan The scanned line.
+ * @param index A pointer to the index in the line (right after the opcode).
+ * @param currentLine The current line number (for error message).
+ * @param filename The name of the source file (for error message).
+ * @param st The st node of the line.
+ * @param errorFlag A pointer to the error flag.
+ * @return 0 if the operation label is valid, -1 otherwise.
+ */
+static int operandsAnalyze(scan_ptr scan,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag);
+
+/**
+ * Analyzes the string directive in the given line.
+ *
+ * @param scan The scanned line.
+ * @param index A pointer to the index in the line (right after the directive).
+ * @param currentLine The current line number (for error message).
+ * @param filename The name of the source file (for error message).
+ * @param st The st node of the line.
+ * @param errorFlag A pointer to the error flag.
+ * @return 0 if the operation label is valid, -1 otherwise.
+ * */
+static int stringDirAnalyze(scan_ptr scan,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag);
+
+/**
+ * Analyzes the data directive in the given line.
+ *
+ * @param scan The scanned line.
+ * @param index A pointer to the index in the line (right after the directive).
+ * @param currentLine The current line number (for error message).
+ * @param filename The name of the source file (for error message).
+ * @param st The st node of the line.
+ * @param errorFlag A pointer to the error flag.
+ * @return 0 if the operation label is valid, -1 otherwise.
+ */
+static int dataDirAnalyze(scan_ptr scan,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag);
+
+/**
+ * Analyzes the external labels in the given line.
+ *
+ * @param scan The scanned line.
+ * @param index A pointer to the index in the line (right after the directive).
+ * @param chunk The chunk of the line (the labels are recorded in it).
+ * @param currentLine The current line number.
+ * @param errorFlag A pointer to the error flag.
+ * @return 0 if the operation label is valid, -1 if memory could not be allocated.
+ */
+static int extLabelsAnalyze(scan_ptr scan, int* index, chunk_ptr chunk, int currentLine, int* errorFlag);
+
+/**
+ * Analyzes the entry label in the given line.
+ *
+ * @param scan The scanned line.
+ * @param index A pointer to the index in the line (right after the directive).
+ * @param chunk The chunk of the line (the label is recorded in it).
+ * @param currentLine The current line number.
+ * @param errorFlag A pointer to the error flag.
+ * @return 0 if the operation label is valid, -1 if memory could not be allocated.
+ */
+static int entryLabelAnalyze(scan_ptr scan, int* index, chunk_ptr chunk, int currentLine, int* errorFlag);
+
+stTable_ptr lexer(buffer_ptr amText, char *filename, int numOfThreads, arena_ptr arena) {
+
+    int i, numOfChunks, numOfLines=0, lineError=FALSE, failed=FALSE, firstLine=1;
+    long start=0;
+    stTable_ptr table;
+    chunk_ptr chunks;
+    threadPool_ptr pool = NULL;
+    if (amText == NULL)
+        return NULL;
+    table = (stTable_ptr) arenaAlloc(arena, sizeof(stTable));
+    MALLOC_CHECK(table)
+    table->sentences = NULL;
+    table->count = 0;
+    table->symbols = createSymbolTable(arena);
+    MALLOC_CHECK(table->symbols)
+
+    /*A small text is not worth splitting, every chunk gets at least MIN_LEX_CHUNK_SIZE characters*/
+    numOfChunks = (numOfThreads > 1) ? (int)(amText->length / MIN_LEX_CHUNK_SIZE) : 1;
+    if(numOfChunks > numOfThreads)
+        numOfChunks = numOfThreads;
+    if(numOfChunks < 1)
+        numOfChunks = 1;
+
+    chunks = (chunk_ptr) calloc(numOfChunks, sizeof(lexChunk));
+    MALLOC_CHECK(chunks)
+
+    /*Splits the text into chunks of whole lines, and finds the line number each chunk starts at*/
+    for (i = 0; i < numOfChunks; i++) {
+        long end = (i == numOfChunks - 1) ? amText->length : amText->length / numOfChunks * (i + 1);
+        const char* endOfLine;
+        if(end < start)
+            end = start;
+        endOfLine = (end < amText->length) ? (const char*) memchr(amText->text + end, END_OF_LINE, amText->length - end) : NULL;
+        end = (endOfLine != NULL) ? endOfLine - amText->text + 1 : amText->length;
+
+        chunks[i].amText = amText;
+        chunks[i].start = start;
+        chunks[i].end = end;
+        chunks[i].firstLine = firstLine;
+        chunks[i].filename = filename;
+        chunks[i].failed = FALSE;
+        chunks[i].diagnostics = createBuffer();
+
+        /*Every thread allocates from an arena of its own, a single chunk uses the arena of the file*/
+        chunks[i].arena = (numOfChunks > 1) ? createArena() : arena;
+        if(chunks[i].diagnostics == NULL || chunks[i].arena == NULL)
+            failed = TRUE;
+        firstLine += countLineNumbers(amText->text + start, end - start);
+        start = end;
+    }
+
+    /*Lexes the chunks on a pool of threads, or right here when there is only one*/
+    if(failed == FALSE){
+        if(numOfChunks > 1)
+            pool = createThreadPool(numOfChunks);
+        for (i = 0; i < numOfChunks; i++) {
+            if(pool == NULL || submitTask(pool, lexChunkTask, &chunks[i]) == FALSE)
+                lexChunkTask(&chunks[i]);
+        }
+        if(pool != NULL){
+            waitForTasks(pool);
+            freeThreadPool(pool);
+        }
+        for (i = 0; i < numOfChunks; i++)
+            if(chunks[i].failed == TRUE)
+                failed = TRUE;
+    }
+
+    /*Merges the chunks in the order of the lines, into one array with room for all of them*/
+    for (i = 0; i < numOfChunks; i++)
+        numOfLines += chunks[i].numOfLines;
+    if(failed == FALSE && numOfLines > 0){
+        table->sentences = (st_ptr) arenaAlloc(arena, numOfLines * sizeof(sentenceTree));
+        if(table->sentences == NULL)
+            failed = TRUE;
+    }
+    if(failed == FALSE){
+        lineError = mergeChunks(chunks, numOfChunks, table);
+        if(checkEntryLabels(table->symbols, filename) == FALSE)
+            lineError = TRUE;
+    }
+    else
+        lineError = TRUE;
+
+    /*The st nodes of the chunks stay in the arena of the file*/
+    for (i = 0; i < numOfChunks; i++) {
+        if(chunks[i].arena != arena)
+            mergeArenas(arena, chunks[i].arena);
+        freeBuffer(chunks[i].diagnostics);
+        SAFE_FREE(chunks[i].lines)
+        SAFE_FREE(chunks[i].events)
+    }
+    free(chunks);
+
+    /*If there were no lines to analyze (a file with comments only),
+     *or there was an error (the tables are freed with the arena)*/
+    if(table->count==0 || lineError==TRUE)
+        return NULL;
+    return table;
+}
+
+static void lexChunkTask(void* arg){
+    chunk_ptr chunk = (chunk_ptr) arg;
+    char line[MAX_LENGTH_LINE_EXTENDED];
+    int currentLine = chunk->firstLine;
+    long position = chunk->start;
+    buffer_ptr previous = getDiagnosticsBuffer();
+
+    /*The messages of the chunk are kept until the chunks are merged
+     *(a chunk lexed on the thread of the file gives the thread its own buffer back)*/
+    setDiagnosticsBuffer(chunk->diagnostics);
+    while (position < chunk->end && readLineFromBuffer(chunk->amText, &position, line, MAX_LENGTH_LINE_EXTENDED) == TRUE) {
+        if(lexLine(chunk, line, &currentLine) == FALSE){
+            chunk->failed = TRUE;
+            break;
+        }
+        currentLine++;
+    }
+    setDiagnosticsBuffer(previous);
+}
+
+static int lexLine(chunk_ptr chunk, char* line, int* currentLine){
+
+    span token;
+    scannedLine scan;
+    char definedLabel[MAX_LABEL_SIZE + 1]={NULL_TERM};
+    const char* filename = chunk->filename;
+    int errorFlag = FALSE, labelFlag=FALSE,keywordType,keywordValue,index=0,length;
+    int* p_errorFlag = &errorFlag;
+    lineResult* result;
+    sentenceTree st;
+    int numbers[MAX_LENGTH_LINE];
+
+    /*Classifies the characters of the line once, the tokens are found from the masks*/
+    length = (int)strlen(line);
+    scanLine(&scan, line, length);
+
+    /*Skips a line without any token*/
+    if (length <= MAX_LENGTH_LINE && nextToken(&scan, &index, &token) == FALSE)
+        return TRUE;
+
+    /*Every other line gets a result, its label definitions are recorded after it*/
+    if(chunk->numOfLines == chunk->linesSize){
+        int newSize = (chunk->linesSize == 0) ? LEX_RESULTS_INITIAL_SIZE : chunk->linesSize * 2;
+        lineResult* newLines = (lineResult*) realloc(chunk->lines, newSize * sizeof(lineResult));
+        if(newLines==NULL){ report("Error: cannot allocate memory\n");return FALSE;}
+        chunk->lines = newLines;
+        chunk->linesSize = newSize;
+    }
+    result = &chunk->lines[chunk->numOfLines];
+    result->hasSentence = FALSE;
+    result->firstEvent = chunk->numOfEvents;
+    result->numOfEvents = 0;
+    chunk->numOfLines++;
+
+    initializeSt(&st);
+
+    /*Checks if the line length is greater than the allowed length*/
+    result->currentLine = *currentLine;
+    if (length > MAX_LENGTH_LINE) {
+        report("Error: line %d is too long in file %s\n", *currentLine, filename);
+        (*currentLine)++;
+        errorFlag = TRUE;
+    }
+
+    if (errorFlag == FALSE) {
+
+        /*In case there's a label*/
+        if (token.start[token.length - 1] == ':'){
+            span labelName;
+            labelName.start = token.start;
+            labelName.length = token.length - 1;
+
+            /*Checks if the symbol is valid, if so, records it for the symbol table*/
+            if(isValidLabel(labelName, filename, *currentLine,p_errorFlag)==TRUE){
+                if(addSymbolEvent(chunk, labelName, relocatable, FALSE)==FALSE)
+                    return FALSE;
+                st.label = labelName;
+                copySpan(definedLabel,labelName);
+                labelFlag=TRUE;
+
+                if(nextToken(&scan, &index, &token)==FALSE){
+                    report("Error: missing command in line %d in %s\n", *currentLine,filename);
+                    errorFlag=TRUE;
+                }
+            }
+        }
+
+        /*Checks if that token is a directive*/
+        keywordType = (errorFlag == FALSE) ? classifyKeyword(token.start, token.length, &keywordValue) : non_keyword;
+        if(keywordType==directive_keyword && errorFlag == FALSE){
+            int dirType = keywordValue, recorded = TRUE;
+            st.sentenceType =  directive;
+            st.directiveType =  dirType;
+
+            /*If this is a DATA directive, will analyze the line (the numbers are kept here until the line is kept)*/
+            if(dirType==DATA){
+                st.directive.numbers = numbers;
+                dataDirAnalyze(&scan,&index,*currentLine,filename,&st,p_errorFlag);
+            }
+
+            /*If this is a STRING directive, will analyze the line*/
+            if(dirType==STRING)
+                stringDirAnalyze(&scan,&index,*currentLine,filename,&st,p_errorFlag);
+
+            /*If this is a ENTRY/EXTERN directive, will analyze the line*/
+            if(dirType == ENTRY || dirType == EXTERN){
+                int type = (dirType==ENTRY)?entry:external;
+                if(labelFlag == TRUE)
+                    report("Warning: The label %s has been defined in line %d  in %s  before .entry/.extern directive\n",definedLabel,*currentLine,filename);
+                switch (type) {
+                    case entry:
+                        recorded = entryLabelAnalyze(&scan,&index,chunk,*currentLine,p_errorFlag);
+                        break;
+                    case external:
+                        recorded = extLabelsAnalyze(&scan,&index,chunk,*currentLine,p_errorFlag);
+                        break;
+                }
+            }
+            if(recorded == FALSE)
+                return FALSE;
+        }
+
+        /*In case there's an instruction*/
+        else if(keywordType==opcode_keyword && errorFlag == FALSE){
+            st.sentenceType =  instruction;
+            st.opcode =  keywordValue;
+            st.numOfOperands = getInstructionInfo(keywordValue)->numOfOperands;
+            operandsAnalyze(&scan,&index,*currentLine,filename,&st,p_errorFlag);
+        }
+
+        /*If no directive or instruction was detected*/
+        else {
+            if(errorFlag==FALSE){
+                report("Error: Undefined command name in line %d in %s\n", *currentLine,filename);
+                errorFlag=TRUE;
+            }
+        }
+    }
+
+    /*Keeps the st node of a line without errors, the label definitions may still fail when merged*/
+    result = &chunk->lines[chunk->numOfLines - 1];
+    result->textEnd = chunk->diagnostics->length;
+    result->numOfEvents = chunk->numOfEvents - result->firstEvent;
+    if(errorFlag==FALSE){
+        if(keepSentence(&st, chunk->arena)==FALSE)
+            return FALSE;
+        result->st = st;
+        result->hasSentence = TRUE;
+    }
+    return TRUE;
+}
+
+static int keepSentence(st_ptr st, arena_ptr arena){
+    span* labels[3];
+    size_t size = 0;
+    char* text;
+    int i;
+
+    /*The numbers come first so they are aligned, then the labels and the string, each with a null terminator*/
+    labels[0] = &st->label;
+    labels[1] = &st->source.label;
+    labels[2] = &st->dest.label;
+    if(st->sentenceType==directive && st->directiveType==DATA)
+        size += st->count * sizeof(int);
+    for (i = 0; i < 3; i++)
+        if(labels[i]->start!=NULL)
+            size += labels[i]->length + 1;
+    if(st->sentenceType==directive && st->directiveType==STRING)
+        size += st->count + 1;
+
+    /*A line without labels or a directive (like stop) has nothing to copy*/
+    if(size == 0)
+        return TRUE;
+    text = (char*) arenaAlloc(arena, size);
+    if(text==NULL)return FALSE;
+
+    if(st->sentenceType==directive && st->directiveType==DATA){
+        memcpy(text, st->directive.numbers, st->count * sizeof(int));
+        st->directive.numbers = (int*) text;
+        text += st->count * sizeof(int);
+    }
+    for (i = 0; i < 3; i++) {
+        if(labels[i]->start!=NULL){
+            copySpan(text, *labels[i]);
+            labels[i]->start = text;
+            text += labels[i]->length + 1;
+        }
+    }
+    if(st->sentenceType==directive && st->directiveType==STRING){
+        memcpy(text, st->directive.str, st->count);
+        text[st->count] = NULL_TERM;
+        st->directive.str = text;
+    }
+    return TRUE;
+}
+
+static int addSymbolEvent(chunk_ptr chunk, span name, int type, int extraneousText){
+    symbolEvent* event;
+
+    if(chunk->numOfEvents == chunk->eventsSize){
+        int newSize = (chunk->eventsSize == 0) ? LEX_RESULTS_INITIAL_SIZE : chunk->eventsSize * 2;
+        symbolEvent* newEvents = (symbolEvent*) realloc(chunk->events, newSize * sizeof(symbolEvent));
+        if(newEvents==NULL){ report("Error: cannot allocate memory\n");return FALSE;}
+        chunk->events = newEvents;
+        chunk->eventsSize = newSize;
+    }
+
+    /*The definition remembers where it is among the messages of the chunk*/
+    event = &chunk->events[chunk->numOfEvents];
+    copySpan(event->name, name);
+    event->type = type;
+    event->textOffset = chunk->diagnostics->length;
+    event->extraneousText = extraneousText;
+    chunk->numOfEvents++;
+    return TRUE;
+}
+
+static int mergeChunks(chunk_ptr chunks, int numOfChunks, stTable_ptr table){
+    int i, j, k, lineError = FALSE;
+
+    for (i = 0; i < numOfChunks; i++) {
+        const char* text = chunks[i].diagnostics->text;
+        long printed = 0;
+
+        for (j = 0; j < chunks[i].numOfLines; j++) {
+            lineResult* result = &chunks[i].lines[j];
+            int errorFlag = (result->hasSentence == FALSE) ? TRUE : FALSE;
+            symbol_ptr defined = NULL;
+
+            /*Reports the messages of the line, and checks every label definition where it was found*/
+            for (k = 0; k < result->numOfEvents; k++) {
+                symbolEvent* event = &chunks[i].events[result->firstEvent + k];
+                reportText(text + printed, event->textOffset - printed);
+                printed = event->textOffset;
+
+                /*A label that is already defined stops the analysis of the rest of the line*/
+                if(applySymbolEvent(event, table->symbols, chunks[i].filename, result->currentLine, &errorFlag, &defined) == FALSE &&
+                   event->type == relocatable){
+                    printed = result->textEnd;
+                    break;
+                }
+            }
+            reportText(text + printed, result->textEnd - printed);
+            printed = result->textEnd;
+
+            /*Adds the st node of a line without errors, linked to the symbol of its label*/
+            if(errorFlag == FALSE){
+                table->sentences[table->count] = result->st;
+                table->sentences[table->count++].symbol = defined;
+            }
+            else
+                lineError = TRUE;
+        }
+    }
+    return lineError;
+}
+
+static int applySymbolEvent(symbolEvent* event, symbolTable_ptr symbols, const char* filename, int currentLine, int* errorFlag, symbol_ptr* defined){
+    symbol_ptr newSymbol;
+
+    if(checkLabelDefinition(event->name, symbols, filename, currentLine, errorFlag, event->type) == FALSE)
+        return FALSE;
+
+    /*Defines the label (an entry label that is already in the table becomes an entry)*/
+    newSymbol = addSymbol(symbols, event->name, event->type);
+    if(newSymbol == NULL){
+        *errorFlag = TRUE;
+        return FALSE;
+    }
+    if(event->type == relocatable)
+        *defined = newSymbol;
+
+    /*Checks for extra text at the end of an entry line*/
+    if (event->extraneousText == TRUE && (*errorFlag) == FALSE) {
+        report("Error: Extraneous text after end of command in line %d in %s\n", currentLine, filename);
+        *errorFlag = TRUE;
+    }
+    return TRUE;
+}
+
+static int checkEntryLabels(symbolTable_ptr symbols, const char* filename){
+    symbol_ptr tempSymbol;
+    int valid = TRUE;
+
+    /*Once all the lines are lexed, an entry label that is not defined in the file is an error*/
+    for (tempSymbol = symbols->head; tempSymbol != NULL; tempSymbol = tempSymbol->next) {
+        if((tempSymbol->flags & SYMBOL_ENTRY) && !(tempSymbol->flags & SYMBOL_DEFINED)){
+            report("Error: the label %s defined as entry, but didn't defined in file %s\n", tempSymbol->name, filename);
+            valid = FALSE;
+        }
+    }
+    return valid;
+}
+
+static int countLineNumbers(const char* text, long length){
+    int numOfLines = 0;
+    long position = 0;
+
+    /*Reads the lines the same way readLineFromBuffer reads them, without copying them*/
+    while (position < length) {
+        long remaining = length - position;
+        long lineLength = (remaining < MAX_LENGTH_LINE_EXTENDED - 1) ? remaining : MAX_LENGTH_LINE_EXTENDED - 1;
+        const char* endOfLine = (const char*) memchr(text + position, END_OF_LINE, lineLength);
+        if(endOfLine != NULL)
+            lineLength = endOfLine - (text + position) + 1;
+        numOfLines += (lineLength > MAX_LENGTH_LINE) ? 2 : 1;
+        position += lineLength;
+    }
+    return numOfLines;
+}
+
+static int getOperandType(span operand,st_ptr st,int op_method,int currentLine,const char* filename,int* errorFlag){
+    int validOperand = FALSE, type, opNum=0;
+
+    /*If the operand may be a register*/
+    if(operand.start[0]=='@' && operand.length==3) {
+
+        /*Checks if the characters after the @ character are a register*/
+        if (classifyKeyword(operand.start + 1, 2, &opNum) == register_keyword) {
+            type = reg;
+            validOperand = TRUE;
+        }
+        else{
+            report("Error: invalid register name in line %d in %s\n",currentLine,filename);
+            SET_ERROR
+        }
+    }
+
+    /*Checks if the operand is a valid number*/
+    if(validOperand == FALSE && parseNumber(operand,MIN_VALID_INS_NUMBER,MAX_VALID_INS_NUMBER,&opNum) == valid_number){
+        type=number;
+        validOperand=TRUE;
+    }
+
+    /*Checks if the operand is a valid label*/
+    if(validOperand==FALSE && isValidOpLabel(operand)==TRUE){
+        type=label;
+        if(op_method==source)
+            st->source.label = operand;
+        else
+            st->dest.label = operand;
+        validOperand=TRUE;
+    }
+
+    /*If not any of them - the operand is not valid*/
+    if(validOperand==FALSE){
+        report("Error: invalid operand given in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+    else{
+        switch (op_method) {
+            case source:
+                st->source.type = type;
+                if(type!= label)
+                    st->source.value = opNum;
+                break;
+            case destination:
+                st->dest.type = type;
+                if(type!= label)
+                    st->dest.value = opNum;
+                break;
+        }
+    }
+    return TRUE;
+}
+
+static int operandsAnalyze(scan_ptr scan,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag){
+    int numOfOperands = st->numOfOperands;
+    const instructionInfo* info = getInstructionInfo(st->opcode);
+    int opCount = 0, separator;
+    span operands[2];
+
+    *index = skipWhite(scan,*index);
+
+    /*If there are no operands at all*/
+    if(*index >= scan->length){
+        if(numOfOperands==0)
+            return TRUE;
+        report("Error: operand not given in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+    if(scan->text[*index]==COMMA){
+        report("Error: operand not given in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+
+    /*Splits the operands by the commas between them*/
+    while (1){
+        readListItem(scan,index,&operands[opCount]);
+        opCount++;
+        separator = readSeparator(scan,index);
+        if(separator==end_of_list)
+            break;
+        if(separator==missing_comma){
+            report("Error: missing comma in line %d in %s\n", currentLine, filename);
+            SET_ERROR
+        }
+        if(separator==multiple_commas){
+            report("Error: multiple commas in line %d in %s\n", currentLine, filename);
+            SET_ERROR
+        }
+
+        /*A comma at the end of the line, or a third operand*/
+        if(separator==trailing_comma || opCount==2){
+            report("Error: Extraneous text after end of command in line %d in %s\n", currentLine,filename);
+            SET_ERROR
+        }
+    }
+
+    /*too many operands error*/
+    if(opCount > numOfOperands){
+        report("Error: too many operands given in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+
+    /*too few operands error*/
+    if(opCount < numOfOperands){
+        report("Error: too few operands given in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+
+    /*operand/s isn't valid*/
+    if(numOfOperands==1){
+        if(getOperandType(operands[0],st,destination,currentLine,filename,errorFlag)==FALSE){
+            SET_ERROR
+        }
+    }
+    if(numOfOperands==2){
+        if(getOperandType(operands[0],st,source,currentLine,filename,errorFlag)==FALSE ||
+           getOperandType(operands[1],st,destination,currentLine,filename,errorFlag)==FALSE){
+            SET_ERROR
+        }
+    }
+
+    /*The operand types the instruction allows (only a number can be a forbidden destination,
+     *and only a number/register a forbidden source)*/
+    if(numOfOperands >= 1 && !(info->destTypes & OPERAND_BIT(st->dest.type))){
+        report("Error: a number cannot be a destination operand in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+    if(numOfOperands == 2 && !(info->sourceTypes & OPERAND_BIT(st->source.type))){
+        report("Error: a number/register cannot be a source operand in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+
+    /*The addressing method of every operand comes from its type (an operand that is not given stays 0)*/
+    if(numOfOperands >= 1)
+        st->dest.adrMethod = operandAddressing[st->dest.type];
+    if(numOfOperands == 2)
+        st->source.adrMethod = operandAddressing[st->source.type];
+    return TRUE;
+}
+
+static int stringDirAnalyze(scan_ptr scan,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag){
+    span str;
+
+    /*If a string is not defined or does not start with apostrophes*/
+    *index = skipWhite(scan,*index);
+    if(*index >= scan->length || scan->text[*index]!=APOSTROPHES){
+        report("Error: a string has been not defined / defined correctly in line %d in %s\n",currentLine,filename);
+        SET_ERROR
+    }
+
+    /*The string is everything up to the closing apostrophes*/
+    str.start = scan->text + (*index) + 1;
+    *index = findNext(scan,*index + 1,SCAN_QUOTE);
+    if(*index >= scan->length){
+        report("Error: missing apostrophes for the string in line %d in %s\n",currentLine,filename);
+        SET_ERROR
+    }
+    str.length = (int)(scan->text + (*index) - str.start);
+
+    /*Checks for extra text at the end of a line (after the closing apostrophes)*/
+    *index = skipWhite(scan,*index + 1);
+    if(*index < scan->length){
+        report("Error: Extraneous text after end of command in line %d in %s\n", currentLine,filename);
+        SET_ERROR
+    }
+
+    /*The string is correct, it is copied (with the character 0 at the end) when the line is kept*/
+    st->directive.str = str.start;
+    st->count = str.length;
+    return TRUE;
+}
+
+static int dataDirAnalyze(scan_ptr scan,int* index,int currentLine,const char* filename,st_ptr st,int* errorFlag) {
+    int number = 0, separator;
+    span parameter;
+
+    /*If the first parameter does not start with a sign (minus/plus) or number*/
+    *index = skipWhite(scan,*index);
+    if (*index >= scan->length || (!isdigit((unsigned char)scan->text[*index]) && scan->text[*index] != MINUS && scan->text[*index] != PLUS)) {
+        report("Error: missing/invalid parameter in line %d in %s\n", currentLine, filename);
+        SET_ERROR
+    }
+
+    while (1) {
+
+        /*Parses the next number of the list*/
+        readListItem(scan,index,&parameter);
+        switch (parseNumber(parameter,MIN_VALID_DIR_NUMBER,MAX_VALID_DIR_NUMBER,&number)) {
+            case multiple_signs:
+                report("Error: multiple signs in line %d in %s\n", currentLine, filename);
+                SET_ERROR
+            case invalid_number:
+                report("Error: invalid parameter in line %d in %s\n", currentLine, filename);
+                SET_ERROR
+            case number_out_of_range:
+                report("Error: the number %d in line %d in %s is outside the allowed range \n", number, currentLine,filename);
+                SET_ERROR
+        }
+        st->directive.numbers[st->count] = number;
+        st->count++;
+
+        /*Checks what separates it from the next number*/
+        separator = readSeparator(scan,index);
+        switch (separator) {
+            case end_of_list:
+                return TRUE;
+            case missing_comma:
+                report("Error: missing comma in line %d in %s\n", currentLine, filename);
+                SET_ERROR
+            case multiple_commas:
+                report("Error: multiple commas in line %d in %s\n", currentLine, filename);
+                SET_ERROR
+            case trailing_comma:
+                report("Error: Extraneous text after end of command in line %d in %s\n", currentLine,filename);
+                SET_ERROR
+        }
+    }
+}
+
+static int extLabelsAnalyze(scan_ptr scan, int* index, chunk_ptr chunk, int currentLine, int* errorFlag) {
+    const char* filename = chunk->filename;
+    span name;
+
+    /*If there are no parameters*/
+    *index = skipWhite(scan, *index);
+    if (*index >= scan->length) {
+        report("Error: missing parameters in line %d in %s\n", currentLine, filename);
+        *errorFlag = TRUE;
+        return TRUE;
+    }
+
+    while (1) {
+
+        /*Each label of the list is checked and recorded on its own*/
+        readListItem(scan, index, &name);
+        if (isValidLabel(name, filename, currentLine, errorFlag) == TRUE &&
+            addSymbolEvent(chunk, name, external, FALSE) == FALSE)
+            return FALSE;
+
+        /*A separator error is reported, and the rest of the list is still checked*/
+        switch (readSeparator(scan, index)) {
+            case end_of_list:
+                return TRUE;
+            case missing_comma:
+                report("Error: missing comma in line %d in %s\n", currentLine, filename);
+                *errorFlag = TRUE;
+                break;
+            case multiple_commas:
+                report("Error: multiple commas in line %d in %s\n", currentLine, filename);
+                *errorFlag = TRUE;
+                break;
+            case trailing_comma:
+                report("Error: missing parameters in line %d in %s\n", currentLine, filename);
+                *errorFlag = TRUE;
+                return TRUE;
+        }
+    }
+}
+
+static int entryLabelAnalyze(scan_ptr scan, int* index, chunk_ptr chunk, int currentLine, int* errorFlag) {
+    span name, extraText;
+
+    /*Only one label is allowed, the extra text is reported only if the label is defined when merged*/
+    nextToken(scan, index, &name);
+    if (isValidLabel(name, chunk->filename, currentLine, errorFlag) == TRUE)
+        return addSymbolEvent(chunk, name, entry, (nextToken(scan, index, &extraText) == TRUE) ? TRUE : FALSE);
+
+    return TRUE;
+}
\ No newline at end of file
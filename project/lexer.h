@@ -1,11 +1,19 @@
-#include "tables.h"
-
-/**
- * Lexically analyzes the given file line by line and constructs a st table
- *
- * @param file The name of the file to analyze.
- * @return A pointer to the head of the st table that created (If there were no errors).
- */
-st_ptr lexer(char* file);
-
-
+#include "tables.h"
+
+#define MIN_LEX_CHUNK_SIZE 65536 /*The minimum number of characters of the am text that are lexed by one thread*/
+#define LEX_RESULTS_INITIAL_SIZE 64 /*The initial number of line results and label definitions of a chunk*/
+
+/**
+ * Lexically analyzes the text of an am file line by line and constructs a st table.
+ * A large text may be split into chunks of whole lines that are lexed by several threads,
+ * the messages and the label definitions are then handled in the order of the lines.
+ *
+ * @param amText The text of the am file (the output of the pre processor).
+ * @param file The name of the am file (for error messages).
+ * @param numOfThreads The maximum number of threads to lex with.
+ * @param arena The arena the st table and the symbol table are allocated from.
+ * @return A pointer to the st table that created (If there were no errors).
+ */
+stTable_ptr lexer(buffer_ptr amText, char* file, int numOfThreads, arena_ptr arena);
+
+
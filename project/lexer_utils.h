@@ -1,77 +1,110 @@
-#ifndef LEXER_UTILS_H
-#define LEXER_UTILS_H
-
-#include "tables.h"
-
-/**
- * Modifies an error flag and returns false for an error
- *
- * @param filePath The path of the file to be released
- */
-#define SET_ERROR \
-    (*errorFlag) = TRUE;\
-    return FALSE;
-
-/**
- * Analyzes the addressing methods for the operands in the st node.
- *
- * @param st The st node of a line.
- */
-void addressingAnalyze(st_ptr st);
-
-/**
- * Finds the first number in the given line, if there's a label, it will skip him.
- *
- * @param line The line to search for the number.
- * @param labelFlag The flag indicating whether a label is present.
- * @param st The st node for the line.
- * @return The index of the first number.
- */
-int findFirstNumber(const char* line, int labelFlag, st_ptr st);
-
-/**
- * Checks whether the given operand label is valid.
- *
- * @param label The operation label to check.
- * @return 0 if the operation label is valid, -1 otherwise.
- */
-int isValidOpLabel(const char* label);
-
-/**
- * Checks whether the given operand number is valid.
- *
- * @param number The operation number to check.
- * @return 0 if the operation label is valid, -1 otherwise.
- */
-int isValidOpNumber(char* number);
-
-/**
- * Gets the number of operands for the specified opcode.
- *
- * @param opcode The opcode.
- * @return The number of operands.
- */
-int getNumOfOperands(int opcode);
-
-/**
- * Analyzes the addressing methods for the operands in the st node.
- *
- * @param st The st node of a line.
- */
-void addressingAnalyze(st_ptr st);
-
-/**
- * Checks whether the given label is valid.
- *
- * @param label The label to check.
- * @param symbol_head The head of the symbol table.
- * @param currentLine The current line number (for error message).
- * @param filename The name of the source file (for error message).
- * @param errorFlag A pointer to the error flag.
- * @param labelType The type of the label (Entry/External/Relocatable).
- * @return 0 if the operation label is valid, -1 otherwise.
- */
-int isValidLabel(const char* label, symbol_ptr symbol_head, const char* filename, int currentLine, int* errorFlag, int labelType);
-
-#endif /* LEXER_UTILS_H */
-
+#ifndef LEXER_UTILS_H
+#define LEXER_UTILS_H
+
+#include "tables.h"
+#include "scan.h"
+
+/**
+ * Modifies an error flag and returns false for an error
+ *
+ * @param filePath The path of the file to be released
+ */
+#define SET_ERROR \
+    (*errorFlag) = TRUE;\
+    return FALSE;
+
+#define MAX_PARSED_NUMBER 100000000L /*A parsed number stops growing beyond this (it is out of range anyway)*/
+
+/**
+ * Enumeration of the results of parsing a number.
+ */
+enum numberStatus {
+    valid_number,        /* A number within the range */
+    invalid_number,      /* Not a number */
+    multiple_signs,      /* A number with more than one sign */
+    number_out_of_range  /* A number outside the range */
+};
+
+/**
+ * Enumeration of the separators between the items of a list (operands, numbers, labels).
+ */
+enum separatorStatus {
+    end_of_list,         /* The line ended after the item */
+    comma_separator,     /* A single comma and then another item */
+    missing_comma,       /* Another item without a comma before it */
+    multiple_commas,     /* More than one comma between the items */
+    trailing_comma       /* A comma and then the end of the line */
+};
+
+/**
+ * Reads the next item of a comma separated list (characters up to a comma, space, tab or end of line).
+ *
+ * @param scan The scanned line to read from.
+ * @param index A pointer to the index in the line, advanced past the item.
+ * @param item The span of the item that was read (may be empty).
+ */
+void readListItem(scan_ptr scan, int* index, span* item);
+
+/**
+ * Reads the separator that comes after an item of a comma separated list.
+ * When another item follows, the index points to its first character.
+ *
+ * @param scan The scanned line to read from.
+ * @param index A pointer to the index in the line, advanced past the separator.
+ * @return The type of the separator (see separatorStatus).
+ */
+int readSeparator(scan_ptr scan, int* index);
+
+/**
+ * Parses a number (an optional sign and then digits) and checks that it is within the range.
+ *
+ * @param number The span of the number.
+ * @param min The minimum valid value.
+ * @param max The maximum valid value.
+ * @param value A pointer to store the value of the number in.
+ * @return The result of the parsing (see numberStatus).
+ */
+int parseNumber(span number, int min, int max, int* value);
+
+/**
+ * Copies the characters of a span to a null terminated string.
+ *
+ * @param dest The array to copy to (must be big enough for the span and the null terminator).
+ * @param part The span to copy.
+ */
+void copySpan(char* dest, span part);
+
+/**
+ * Checks whether the given operand label is valid.
+ *
+ * @param label The operand label to check.
+ * @return 0 if the operation label is valid, -1 otherwise.
+ */
+int isValidOpLabel(span label);
+
+/**
+ * Checks whether the given label is a valid label name.
+ *
+ * @param label The label to check (start is NULL if the label is missing).
+ * @param currentLine The current line number (for error message).
+ * @param filename The name of the source file (for error message).
+ * @param errorFlag A pointer to the error flag.
+ * @return 0 if the label is valid, -1 otherwise.
+ */
+int isValidLabel(span label, const char* filename, int currentLine, int* errorFlag);
+
+/**
+ * Checks whether the given label can be defined with the given type,
+ * it cannot be defined twice with the same type, and an external label cannot be defined in the file or be an entry.
+ *
+ * @param label The label to check.
+ * @param symbols The symbol table.
+ * @param currentLine The current line number (for error message).
+ * @param filename The name of the source file (for error message).
+ * @param errorFlag A pointer to the error flag.
+ * @param labelType The type of the label (Entry/External/Relocatable).
+ * @return 0 if the label can be defined, -1 otherwise.
+ */
+int checkLabelDefinition(const char* label, symbolTable_ptr symbols, const char* filename, int currentLine, int* errorFlag, int labelType);
+
+#endif /* LEXER_UTILS_H */
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "objectFile.h"
+#include "outputFile.h"
+#include "diagnostics.h"
+#include "globals.h"
+#include "utils.h"
+
+/**
+ * Puts a number of 2 bytes (little endian) in the object file.
+ *
+ * @param at Where to put the number.
+ * @param value The number.
+ */
+static void putShort(unsigned char* at, unsigned long value);
+
+/**
+ * Puts a number of 4 bytes (little endian) in the object file.
+ *
+ * @param at Where to put the number.
+ * @param value The number.
+ */
+static void putLong(unsigned char* at, unsigned long value);
+
+/**
+ * Fills the memory image with the words of the program (the code at ADDRESS_START and then the data).
+ *
+ * @param image The memory image (CP_MEMORY words of 2 bytes, zeroed).
+ * @param wordTable_head The word table.
+ */
+static void fillImage(unsigned char* image, wordTable_ptr wordTable_head);
+
+/**
+ * Puts a relocation in the object file.
+ *
+ * @param at Where to put the relocation.
+ * @param index The index of the word in the code.
+ * @param are The ARE bits of the word.
+ * @param nameOffset The offset of the name of the external symbol (OBJ_NO_NAME for a relocatable word).
+ */
+static void putRelocation(unsigned char* at, int index, int are, unsigned long nameOffset);
+
+int createObjFile(char* file, symbolTable_ptr symbols, wordTable_ptr wordTable_head){
+    symbol_ptr tempSymbol;
+    fixup_ptr reference;
+    unsigned char* obj;
+    unsigned long wordsOffset, entriesOffset, relocationsOffset, namesOffset, namesLength = 0, size;
+    unsigned char* entrySymbol;
+    unsigned char* relocation;
+    char* names;
+    int i, numOfWords = wordTable_head->IC + wordTable_head->DC, numOfEntries = 0, numOfRelocations = 0;
+    int committed;
+
+    /*Counts the entry symbols, the relocations and the length of the names to know the size of the file*/
+    for (tempSymbol = symbols->head; tempSymbol != NULL; tempSymbol = tempSymbol->next) {
+        if(tempSymbol->flags & (SYMBOL_ENTRY | SYMBOL_EXTERNAL))
+            namesLength += strlen(tempSymbol->name) + 1;
+        if(tempSymbol->flags & SYMBOL_ENTRY)
+            numOfEntries++;
+    }
+    for (i = 0; i < wordTable_head->numOfFixups; i++)
+        if(wordTable_head->fixups[i].symbol != NULL)
+            numOfRelocations++;
+    wordsOffset = OBJ_HEADER_SIZE;
+    entriesOffset = OBJ_ALIGN(wordsOffset + 2UL * numOfWords);
+    relocationsOffset = entriesOffset + (unsigned long)OBJ_ENTRY_SIZE * numOfEntries;
+    namesOffset = relocationsOffset + (unsigned long)OBJ_RELOCATION_SIZE * numOfRelocations;
+    size = namesOffset + namesLength;
+
+    /*The whole file is built in memory (the padding is zeros)*/
+    obj = (unsigned char*) calloc(size, 1);
+    if(obj==NULL){ report("Error: cannot allocate memory for the output file %s.obj\n", file);return FALSE;}
+    memcpy(obj, OBJ_MAGIC, 4);
+    putShort(obj + 4, OBJ_VERSION);
+    putShort(obj + 6, OBJ_HEADER_SIZE);
+    putShort(obj + 8, wordTable_head->IC);
+    putShort(obj + 10, wordTable_head->DC);
+    putShort(obj + 12, numOfEntries);
+    putShort(obj + 14, numOfRelocations);
+    putLong(obj + 16, wordsOffset);
+    putLong(obj + 20, entriesOffset);
+    putLong(obj + 24, relocationsOffset);
+    putLong(obj + 28, namesOffset);
+    putLong(obj + 32, namesLength);
+
+    /*The code and then the data*/
+    for (i = 0; i < wordTable_head->IC; i++)
+        putShort(obj + wordsOffset + 2 * i, wordTable_head->code[i]);
+    for (i = 0; i < wordTable_head->DC; i++)
+        putShort(obj + wordsOffset + 2 * (wordTable_head->IC + i), wordTable_head->data[i]);
+
+    /*The relocatable words, in the order of the words*/
+    relocation = obj + relocationsOffset;
+    for (i = 0; i < wordTable_head->numOfFixups; i++) {
+        reference = &wordTable_head->fixups[i];
+        if(reference->symbol != NULL && !(reference->symbol->flags & SYMBOL_EXTERNAL)){
+            putRelocation(relocation, reference->index, ARE_RELOCATABLE, OBJ_NO_NAME);
+            relocation += OBJ_RELOCATION_SIZE;
+        }
+    }
+
+    /*The entry symbols, and their names*/
+    entrySymbol = obj + entriesOffset;
+    names = (char*) obj + namesOffset;
+    for (tempSymbol = symbols->head; tempSymbol != NULL; tempSymbol = tempSymbol->next) {
+        if(tempSymbol->flags & SYMBOL_ENTRY){
+            putLong(entrySymbol, (unsigned long)(names - ((char*) obj + namesOffset)));
+            putShort(entrySymbol + 4, tempSymbol->address);
+            entrySymbol += OBJ_ENTRY_SIZE;
+            strcpy(names, tempSymbol->name);
+            names += strlen(tempSymbol->name) + 1;
+        }
+    }
+
+    /*The external symbols, their names and the words that reference them*/
+    for (tempSymbol = symbols->externalHead; tempSymbol != NULL; tempSymbol = tempSymbol->nextExternal) {
+        unsigned long nameOffset = (unsigned long)(names - ((char*) obj + namesOffset));
+        strcpy(names, tempSymbol->name);
+        names += strlen(tempSymbol->name) + 1;
+        for (reference = tempSymbol->firstFixup; reference != NULL; reference = reference->nextOfSymbol) {
+            putRelocation(relocation, reference->index, ARE_EXTERNAL, nameOffset);
+            relocation += OBJ_RELOCATION_SIZE;
+        }
+    }
+
+    committed = commitOutputFile(file, ".obj", obj, size);
+    free(obj);
+    return committed;
+}
+
+int createImageFile(char* file, wordTable_ptr wordTable_head){
+    unsigned char image[2 * CP_MEMORY];
+
+    memset(image, 0, sizeof(image));
+    fillImage(image, wordTable_head);
+    return commitOutputFile(file, ".img", image, sizeof(image));
+}
+
+int createHexFile(char* file, wordTable_ptr wordTable_head){
+    unsigned char image[2 * CP_MEMORY];
+    long start = 2L * ADDRESS_START, end = 2L * (ADDRESS_START + wordTable_head->IC + wordTable_head->DC);
+    long address, length = 0;
+    char* text;
+    int committed;
+
+    memset(image, 0, sizeof(image));
+    fillImage(image, wordTable_head);
+    if(end > (long)sizeof(image))
+        end = sizeof(image);
+
+    /*A record line for every HEX_RECORD_LENGTH bytes of the program, and the end of file record*/
+    text = (char*) malloc(((end - start) / HEX_RECORD_LENGTH + 2) * HEX_RECORD_MAX_LINE);
+    if(text==NULL){ report("Error: cannot allocate memory for the output file %s.hex\n", file);return FALSE;}
+    for (address = start; address < end; address += HEX_RECORD_LENGTH) {
+        int count = (end - address < HEX_RECORD_LENGTH) ? (int)(end - address) : HEX_RECORD_LENGTH, i;
+        unsigned int checksum = count + ((address >> 8) & 0xFF) + (address & 0xFF);
+
+        /*:, the number of bytes, the address, the record type (00 - data), the bytes and the checksum*/
+        length += sprintf(text + length, ":%02X%04lX00", count, address);
+        for (i = 0; i < count; i++) {
+            length += sprintf(text + length, "%02X", image[address + i]);
+            checksum += image[address + i];
+        }
+        length += sprintf(text + length, "%02X\n", (unsigned int)((0x100 - (checksum & 0xFF)) & 0xFF));
+    }
+    length += sprintf(text + length, ":00000001FF\n");
+
+    committed = commitOutputFile(file, ".hex", text, length);
+    free(text);
+    return committed;
+}
+
+static void fillImage(unsigned char* image, wordTable_ptr wordTable_head){
+    int i;
+
+    /*A word past the memory is not in the image (the first pass does not let it happen)*/
+    for (i = 0; i < wordTable_head->IC && ADDRESS_START + i < CP_MEMORY; i++)
+        putShort(image + 2 * (ADDRESS_START + i), wordTable_head->code[i]);
+    for (i = 0; i < wordTable_head->DC && ADDRESS_START + wordTable_head->IC + i < CP_MEMORY; i++)
+        putShort(image + 2 * (ADDRESS_START + wordTable_head->IC + i), wordTable_head->data[i]);
+}
+
+static void putShort(unsigned char* at, unsigned long value){
+    at[0] = (unsigned char)(value & 0xFF);
+    at[1] = (unsigned char)((value >> 8) & 0xFF);
+}
+
+static void putLong(unsigned char* at, unsigned long value){
+    putShort(at, value & 0xFFFF);
+    putShort(at + 2, (value >> 16) & 0xFFFF);
+}
+
+static void putRelocation(unsigned char* at, int index, int are, unsigned long nameOffset){
+    putShort(at, ADDRESS_START + index);
+    at[2] = (unsigned char) are;
+    at[3] = 0;
+    putLong(at + 4, nameOffset);
+}
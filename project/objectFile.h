@@ -0,0 +1,81 @@
+#ifndef OBJECT_FILE_H
+#define OBJECT_FILE_H
+
+#include "tables.h"
+
+/*The binary object file (.obj): the same program as the .ob/.ent/.ext files, laid out to be used
+ *in place (mapped into memory) without parsing. All the numbers are little endian, every section
+ *starts at an offset that is a multiple of 4, and the offsets are from the start of the file.
+ *
+ *Header (OBJ_HEADER_SIZE bytes):
+ *   0  4 bytes  OBJ_MAGIC
+ *   4  2 bytes  OBJ_VERSION
+ *   6  2 bytes  the size of the header
+ *   8  2 bytes  IC (the number of code words)
+ *  10  2 bytes  DC (the number of data words)
+ *  12  2 bytes  the number of entry symbols
+ *  14  2 bytes  the number of relocations
+ *  16  4 bytes  the offset of the words
+ *  20  4 bytes  the offset of the entry symbols
+ *  24  4 bytes  the offset of the relocations
+ *  28  4 bytes  the offset of the names
+ *  32  4 bytes  the length of the names
+ *
+ *Words: IC+DC words of 2 bytes (the 12 bits of the word in the low bits), the code and then the data,
+ *the word at index i is at address ADDRESS_START+i.
+ *
+ *Entry symbols (OBJ_ENTRY_SIZE bytes each, in the order the symbols were defined):
+ *   0  4 bytes  the offset of the name in the names
+ *   4  2 bytes  the address of the symbol
+ *   6  2 bytes  0
+ *
+ *Relocations (OBJ_RELOCATION_SIZE bytes each, a relocation for every label operand word: the relocatable
+ *ones in the order of the words, then the external ones by symbol in the order of the .ext file):
+ *   0  2 bytes  the address of the word
+ *   2  1 byte   the ARE bits of the word (ARE_RELOCATABLE/ARE_EXTERNAL)
+ *   3  1 byte   0
+ *   4  4 bytes  the offset of the name of the external symbol in the names (OBJ_NO_NAME for a relocatable word)
+ *
+ *Names: the names of the entry symbols and then of the external symbols, each null terminated*/
+#define OBJ_MAGIC "AS12"
+#define OBJ_VERSION 1
+#define OBJ_HEADER_SIZE 36
+#define OBJ_ENTRY_SIZE 8
+#define OBJ_RELOCATION_SIZE 8
+#define OBJ_NO_NAME 0xFFFFFFFFUL
+#define OBJ_ALIGN(offset) (((offset) + 3) & ~3UL) /*Rounds an offset up to a multiple of 4*/
+
+#define HEX_RECORD_LENGTH 16 /*The number of bytes of the memory image in a data record of the Intel HEX file*/
+#define HEX_RECORD_MAX_LINE 44 /*The length of a record line of the Intel HEX file (with HEX_RECORD_LENGTH bytes)*/
+
+/**
+ * Creates the memory image file (.img): the whole memory of CP_MEMORY words of 2 bytes (little endian),
+ * with the code at address ADDRESS_START, the data right after it and zeros everywhere else.
+ *
+ * @param file The file name (without an extension).
+ * @param wordTable_head The word table (after the label words were filled).
+ * @return 0 if the image file was written (or already had the same content), -1 otherwise.
+ */
+int createImageFile(char* file, wordTable_ptr wordTable_head);
+
+/**
+ * Creates the Intel HEX file (.hex) of the memory image: data records of HEX_RECORD_LENGTH bytes
+ * of the image (byte address = 2 * word address) for the words of the program, and an end of file record.
+ *
+ * @param file The file name (without an extension).
+ * @param wordTable_head The word table (after the label words were filled).
+ * @return 0 if the hex file was written (or already had the same content), -1 otherwise.
+ */
+int createHexFile(char* file, wordTable_ptr wordTable_head);
+
+/**
+ * Creates the binary object file (.obj) of a file that was assembled without errors.
+ *
+ * @param file The file name (without an extension).
+ * @param symbols The symbol table (with the fixups of the external symbols).
+ * @param wordTable_head The word table (after the label words were filled).
+ * @return 0 if the object file was written (or already had the same content), -1 otherwise.
+ */
+int createObjFile(char* file, symbolTable_ptr symbols, wordTable_ptr wordTable_head);
+
+#endif /* OBJECT_FILE_H */
@@ -0,0 +1,255 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "outputFile.h"
+#include "fileIO.h"
+#include "diagnostics.h"
+#include "globals.h"
+#include "utils.h"
+
+/*An output that waits to be committed*/
+typedef struct pendingOutput{
+
+    /*The name of the file*/
+    char* fileName;
+
+    /*The content of the file (NULL if the file should not exist)*/
+    char* text;
+    long length;
+
+}pendingOutput;
+
+struct outputBatch{
+
+    /*The outputs in the order they were committed (a file appears once, with its last content)*/
+    pendingOutput* outputs;
+    int count;
+    int size;
+
+};
+
+/*The key of the output batch of every thread (created once)*/
+static pthread_key_t batchKey;
+static pthread_once_t batchKeyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Creates the key of the output batches.
+ */
+static void createBatchKey(void);
+
+/**
+ * Keeps an output in a batch (a copy of its content), in place of an earlier output of the same file.
+ *
+ * @param batch The batch.
+ * @param fileName The name of the file (the batch takes it).
+ * @param text The content of the file (NULL if the file should not exist).
+ * @param length The length of the content.
+ * @return 0 if the output was kept, -1 if memory could not be allocated.
+ */
+static int keepOutput(outputBatch_ptr batch, char* fileName, const void* text, long length);
+
+/**
+ * Commits outputs together: files that already have the same content are left as they are, the files
+ * without content are removed, and the rest are replaced.
+ *
+ * @param outputs The outputs.
+ * @param numOfOutputs The number of outputs.
+ * @return 0 if every file is as its content, -1 otherwise.
+ */
+static int commitOutputs(pendingOutput* outputs, int numOfOutputs);
+
+int commitOutputFile(const char* file, char* ext, const void* text, long length){
+    pendingOutput output;
+    outputBatch_ptr batch;
+    int committed;
+
+    output.fileName = setOutputFile(file, ext);
+    if(output.fileName==NULL){
+        report("Error: cannot write the output file %s%s\n", file, ext);
+        return FALSE;
+    }
+    output.text = (length > 0) ? (char*) text : NULL;
+    output.length = (output.text != NULL) ? length : 0;
+
+    /*A thread with a batch commits its outputs when the batch is flushed*/
+    pthread_once(&batchKeyOnce, createBatchKey);
+    batch = (outputBatch_ptr) pthread_getspecific(batchKey);
+    if(batch != NULL)
+        return keepOutput(batch, output.fileName, output.text, output.length);
+
+    committed = commitOutputs(&output, 1);
+    free(output.fileName);
+    return committed;
+}
+
+outputBatch_ptr createOutputBatch(void){
+    outputBatch_ptr batch = (outputBatch_ptr) malloc(sizeof(struct outputBatch));
+    if(batch==NULL){
+        report("Error: cannot allocate memory for a batch of output files\n");
+        return NULL;
+    }
+    batch->outputs = (pendingOutput*) malloc(OUTPUT_BATCH_INITIAL_SIZE * sizeof(pendingOutput));
+    if(batch->outputs==NULL){
+        free(batch);
+        report("Error: cannot allocate memory for a batch of output files\n");
+        return NULL;
+    }
+    batch->count = 0;
+    batch->size = OUTPUT_BATCH_INITIAL_SIZE;
+    return batch;
+}
+
+int setOutputBatch(outputBatch_ptr batch){
+    pthread_once(&batchKeyOnce, createBatchKey);
+    if(pthread_setspecific(batchKey, batch) != 0)
+        return FALSE;
+    return TRUE;
+}
+
+int flushOutputBatch(outputBatch_ptr batch){
+    int i, committed;
+
+    if(batch==NULL || batch->count==0)return TRUE;
+    committed = commitOutputs(batch->outputs, batch->count);
+    for (i = 0; i < batch->count; i++) {
+        free(batch->outputs[i].fileName);
+        SAFE_FREE(batch->outputs[i].text)
+    }
+    batch->count = 0;
+    return committed;
+}
+
+void forEachBatchOutput(outputBatch_ptr batch, outputVisitor visit, void* arg){
+    int i;
+
+    if(batch==NULL)return;
+    for (i = 0; i < batch->count; i++)
+        visit(batch->outputs[i].fileName, batch->outputs[i].text, batch->outputs[i].length, arg);
+}
+
+void freeOutputBatch(outputBatch_ptr batch){
+    int i;
+
+    if(batch==NULL)return;
+    for (i = 0; i < batch->count; i++) {
+        free(batch->outputs[i].fileName);
+        SAFE_FREE(batch->outputs[i].text)
+    }
+    free(batch->outputs);
+    free(batch);
+}
+
+static void createBatchKey(void){
+    pthread_key_create(&batchKey, NULL);
+}
+
+static int keepOutput(outputBatch_ptr batch, char* fileName, const void* text, long length){
+    char* copy = NULL;
+    int i;
+
+    if(text != NULL){
+        copy = (char*) malloc(length);
+        if(copy==NULL){
+            report("Error: cannot write the output file %s\n", fileName);
+            free(fileName);
+            return FALSE;
+        }
+        memcpy(copy, text, length);
+    }
+
+    /*A file that is committed again in the batch gets its new content*/
+    for (i = 0; i < batch->count; i++) {
+        if(strcmp(batch->outputs[i].fileName, fileName) == 0){
+            free(fileName);
+            SAFE_FREE(batch->outputs[i].text)
+            batch->outputs[i].text = copy;
+            batch->outputs[i].length = length;
+            return TRUE;
+        }
+    }
+
+    /*Doubles the outputs when they are full*/
+    if(batch->count == batch->size){
+        pendingOutput* newOutputs = (pendingOutput*) realloc(batch->outputs, 2 * batch->size * sizeof(pendingOutput));
+        if(newOutputs==NULL){
+            report("Error: cannot write the output file %s\n", fileName);
+            free(fileName);
+            SAFE_FREE(copy)
+            return FALSE;
+        }
+        batch->outputs = newOutputs;
+        batch->size *= 2;
+    }
+    batch->outputs[batch->count].fileName = fileName;
+    batch->outputs[batch->count].text = copy;
+    batch->outputs[batch->count].length = length;
+    batch->count++;
+    return TRUE;
+}
+
+static int commitOutputs(pendingOutput* outputs, int numOfOutputs){
+    char** names = (char**) malloc(numOfOutputs * sizeof(char*));
+    buffer_ptr* oldTexts = (buffer_ptr*) malloc(numOfOutputs * sizeof(buffer_ptr));
+    fileWrite* writes = (fileWrite*) malloc(numOfOutputs * sizeof(fileWrite));
+    int* removed = (int*) malloc(numOfOutputs * sizeof(int));
+    int i, numOfReads = 0, numOfRemoves = 0, numOfWrites = 0, committed = TRUE;
+
+    if(names==NULL || oldTexts==NULL || writes==NULL || removed==NULL){
+        SAFE_FREE(names)
+        SAFE_FREE(oldTexts)
+        SAFE_FREE(writes)
+        SAFE_FREE(removed)
+        for (i = 0; i < numOfOutputs; i++)
+            report("Error: cannot write the output file %s\n", outputs[i].fileName);
+        return FALSE;
+    }
+
+    /*An output without content is not created, and the file of an earlier run is removed*/
+    for (i = 0; i < numOfOutputs; i++)
+        if(outputs[i].text == NULL)
+            names[numOfRemoves++] = outputs[i].fileName;
+    removeFiles(names, numOfRemoves, removed);
+    for (i = 0; i < numOfRemoves; i++) {
+        if(removed[i] == FALSE){
+            report("Error: cannot remove the output file %s (left from an earlier run)\n", names[i]);
+            committed = FALSE;
+        }
+    }
+
+    /*The same content is not written again, the files are read back to compare*/
+    for (i = 0; i < numOfOutputs; i++)
+        if(outputs[i].text != NULL)
+            names[numOfReads++] = outputs[i].fileName;
+    readFiles(names, numOfReads, oldTexts);
+    numOfReads = 0;
+    for (i = 0; i < numOfOutputs; i++) {
+        buffer_ptr oldText;
+        if(outputs[i].text == NULL)
+            continue;
+        oldText = oldTexts[numOfReads++];
+        if(oldText == NULL || oldText->length != outputs[i].length || memcmp(oldText->text, outputs[i].text, outputs[i].length) != 0){
+            writes[numOfWrites].fileName = outputs[i].fileName;
+            writes[numOfWrites].text = outputs[i].text;
+            writes[numOfWrites].length = outputs[i].length;
+            numOfWrites++;
+        }
+        freeBuffer(oldText);
+    }
+
+    replaceFiles(writes, numOfWrites);
+    for (i = 0; i < numOfWrites; i++) {
+        if(writes[i].result == FALSE){
+            report("Error: cannot write the output file %s\n", writes[i].fileName);
+            committed = FALSE;
+        }
+    }
+
+    free(names);
+    free(oldTexts);
+    free(writes);
+    free(removed);
+    return committed;
+}
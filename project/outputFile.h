@@ -0,0 +1,68 @@
+#ifndef OUTPUT_FILE_H
+#define OUTPUT_FILE_H
+
+#define OUTPUT_BATCH_INITIAL_SIZE 16 /*The initial number of outputs a batch can hold*/
+
+/*Outputs that are kept in memory and committed together (its content is private to outputFile.c)*/
+typedef struct outputBatch * outputBatch_ptr;
+
+/*A function that is given every output of a batch (text is NULL if the file should not exist)*/
+typedef void (*outputVisitor)(const char* fileName, const char* text, long length, void* arg);
+
+/**
+ * Commits the content of an output file that was built in memory.
+ * The content is written to a temporary file that is then renamed to the file, so the file is never
+ * seen half written. A file that already has the same content is not written at all (it keeps its time),
+ * and an output without content removes the file an earlier run may have left.
+ * If an output batch was set for the calling thread, the output is kept in it and committed when it is flushed.
+ * An output that cannot be written (or removed) is reported by its file name.
+ *
+ * @param file The file name (without an extension).
+ * @param ext The extension of the output file.
+ * @param text The content of the file (NULL if the file should not exist).
+ * @param length The length of the content (0 if the file should not exist).
+ * @return 0 if the file is as the content (or was kept in the batch), -1 otherwise.
+ */
+int commitOutputFile(const char* file, char* ext, const void* text, long length);
+
+/**
+ * Creates an empty output batch.
+ *
+ * @return A pointer to the new batch, or NULL if memory could not be allocated.
+ */
+outputBatch_ptr createOutputBatch(void);
+
+/**
+ * Sets the batch that keeps the outputs committed by the calling thread.
+ *
+ * @param batch The batch to keep the outputs in, or NULL to commit them right away.
+ * @return 0 if the batch was set, -1 otherwise.
+ */
+int setOutputBatch(outputBatch_ptr batch);
+
+/**
+ * Commits all the outputs kept in a batch together (the batch is empty afterwards).
+ * Every output that cannot be written (or removed) is reported by its file name.
+ *
+ * @param batch The batch.
+ * @return 0 if every file is as its content, -1 otherwise.
+ */
+int flushOutputBatch(outputBatch_ptr batch);
+
+/**
+ * Gives every output kept in a batch to a function, in the order they were committed.
+ *
+ * @param batch The batch.
+ * @param visit The function.
+ * @param arg The argument to pass to the function.
+ */
+void forEachBatchOutput(outputBatch_ptr batch, outputVisitor visit, void* arg);
+
+/**
+ * Frees a batch (outputs that were not flushed are dropped).
+ *
+ * @param batch The batch to free.
+ */
+void freeOutputBatch(outputBatch_ptr batch);
+
+#endif /* OUTPUT_FILE_H */
@@ -1,130 +1,171 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "tables.h"
-#include "utils.h"
-#include "preprocess.h"
-#include "globals.h"
-
-char* preProcessor(char* asFileName,char* originFile){
-
-    char* amFilename = setOutputFile(originFile,".am");
-    FILE* asFile = fopen(asFileName, "r");
-    FILE* amFile = fopen(amFilename, "w");
-    char* delim = " \t\n";
-    char* line;
-    char* lineCopy;
-    int currentLine=1,mcrFlag=FALSE,macroIndex;
-    macroPtr head = NULL,lastMcr= NULL;
-    long originalPosition;
-
-    lineCopy = (char *) malloc(MAX_LENGTH_LINE_EXTENDED);
-    line = (char *) malloc(MAX_LENGTH_LINE_EXTENDED);
-
-    FILE_CHECK(asFile)
-    MALLOC_CHECK(line)
-    MALLOC_CHECK(lineCopy)
-
-
-    while (fgets(line, MAX_LENGTH_LINE_EXTENDED, asFile)) {
-        char* command;
-        strcpy(lineCopy,line);
-        command = strtok(line, delim);
-
-        /*Skips a blank line and a comment line*/
-        if(command!=NULL && command[0]!=COMMENT){
-
-            /*Checks whether a macro is in the definition*/
-            macroIndex = isMacro(head,command);
-            if (macroIndex != FALSE) {
-                originalPosition = ftell(asFile);
-                printMacroToFile(asFile,amFile,macroIndex,head);
-                fseek(asFile, originalPosition, SEEK_SET);
-            }
-
-            /*Checks whether the line starts with a macro definition*/
-            if (strcmp(command, "mcro") == TRUE) {
-                char *mcrName;
-                macroPtr temp;
-
-                mcrName = (char *) malloc(*command + 1);
-                temp = (macroPtr) malloc(sizeof(macro));
-
-                MALLOC_CHECK(mcrName)
-                MALLOC_CHECK(temp)
-
-                command = strtok(NULL, delim);
-
-                if(isInstructionLabel(command) != non_op || isDirectiveLabel(command) != non_dir || isRegisterLabel(command) != non_reg){
-                    printf("Error: Macro name cannot be Instruction/Directive/Register name in file %s.as\n",originFile);
-                    remove(amFilename);
-                    SAFE_FREE(amFilename)
-                    return NULL;
-                }
-
-                else if(command==NULL){
-                    printf("Error: Macro name is not defined in file %s.as\n",originFile);
-                    remove(amFilename);
-                    SAFE_FREE(amFilename)
-                    return NULL;
-                }
-
-                /*Creates a macro link with a starting line*/
-                mcrFlag=TRUE;
-                strcpy(mcrName, command);
-                temp->name = mcrName;
-                temp->startLine = currentLine + 1;
-                temp->next=NULL;
-
-                if (head == NULL){
-                    head = temp;
-                    lastMcr = head;
-                }
-                else {
-                    lastMcr->next = temp;
-                    lastMcr = temp;
-                }
-
-                command = strtok(NULL, delim);
-
-                if(command!=NULL){
-                    printf("Error: Extraneous text after end of macro definition in file %s.as\n",originFile);
-                    remove(amFilename);
-                    SAFE_FREE(amFilename)
-                    return NULL;
-                }
-
-            }
-
-            /*If the line is a closing macro*/
-            else if (strcmp(command, "endmcro") == TRUE) {
-                lastMcr->endingLine = currentLine-1;
-                mcrFlag=FALSE;
-            }
-
-            /*If the line is a line without a macro definition*/
-            else if(mcrFlag==FALSE  && macroIndex == FALSE){
-                fprintf(amFile, "%s", lineCopy);
-            }
-        }
-        currentLine++;
-    }
-
-    /*Frees all allocated memory*/
-    free(lineCopy);
-    free(line);
-    fclose(amFile);
-    fclose(asFile);
-    freeMacroTable(head);
-
-    /*if the file is empty*/
-    if(currentLine==1){
-        remove(amFilename);
-        return NULL;
-    }
-
-    /*name of the created am file*/
-    return amFilename;
-}
-
-
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tables.h"
+#include "utils.h"
+#include "preprocess.h"
+#include "diagnostics.h"
+#include "globals.h"
+
+/**
+ * Reads the next word of a line. Unlike strtok it keeps no state of its own,
+ * so files can be preprocessed on several threads at once.
+ * The word is ended with a null terminator in the line.
+ *
+ * @param position A pointer to where to continue reading the line from, advanced past the word.
+ * @param delim The characters that separate the words.
+ * @return The word, or NULL if there are no more words in the line.
+ */
+static char* nextWord(char** position, const char* delim);
+
+buffer_ptr preProcessor(buffer_ptr asText,char* originFile){
+
+    buffer_ptr amText = createBuffer();
+    char* delim = " \t\n";
+    char* line;
+    char* lineCopy;
+    int currentLine=1,mcrFlag=FALSE,failed=FALSE,noMemory=FALSE;
+    long position=0;
+    macroTable_ptr macros = createMacroTable();
+    macroPtr usedMcr,lastMcr= NULL;
+
+    lineCopy = (char *) malloc(MAX_LENGTH_LINE_EXTENDED);
+    line = (char *) malloc(MAX_LENGTH_LINE_EXTENDED);
+
+    if(line==NULL || lineCopy==NULL || macros==NULL || amText==NULL)
+        noMemory=TRUE;
+
+    /*An error stops the preprocessing, and everything is freed in one place after the loop*/
+    while (failed==FALSE && noMemory==FALSE && readLineFromBuffer(asText, &position, line, MAX_LENGTH_LINE_EXTENDED) == TRUE) {
+        char* command;
+        char* rest = line;
+        strcpy(lineCopy,line);
+        command = nextWord(&rest, delim);
+
+        /*Skips a blank line and a comment line*/
+        if(command!=NULL && command[0]!=COMMENT){
+
+            /*Checks whether a macro is in the definition*/
+            usedMcr = searchForMacro(macros,command);
+            if (usedMcr != NULL && appendToBuffer(amText,usedMcr->body->text,usedMcr->body->length)==FALSE){
+                noMemory=TRUE;
+                break;
+            }
+
+            /*Checks whether the line starts with a macro definition*/
+            if (strcmp(command, "mcro") == TRUE) {
+                char *mcrName;
+                macroPtr temp;
+
+                command = nextWord(&rest, delim);
+
+                if(command!=NULL && classifyKeyword(command,(int)strlen(command),NULL) != non_keyword){
+                    report("Error: Macro name cannot be Instruction/Directive/Register name in file %s.as\n",originFile);
+                    failed=TRUE;
+                    break;
+                }
+
+                else if(command==NULL){
+                    report("Error: Macro name is not defined in file %s.as\n",originFile);
+                    failed=TRUE;
+                    break;
+                }
+
+                mcrName = (char *) malloc(strlen(command) + 1);
+                temp = (macroPtr) malloc(sizeof(macro));
+                if(temp!=NULL)
+                    temp->body = createBuffer();
+
+                /*A macro that is not in the table yet is freed here*/
+                if(mcrName==NULL || temp==NULL || temp->body==NULL){
+                    SAFE_FREE(mcrName)
+                    if(temp!=NULL)
+                        freeBuffer(temp->body);
+                    SAFE_FREE(temp)
+                    noMemory=TRUE;
+                    break;
+                }
+
+                /*Creates a macro link, its body is filled by the lines that follow*/
+                mcrFlag=TRUE;
+                strcpy(mcrName, command);
+                temp->name = mcrName;
+                temp->next=NULL;
+                if(addToMacroTable(macros,temp)==FALSE){
+                    free(mcrName);
+                    freeBuffer(temp->body);
+                    free(temp);
+                    noMemory=TRUE;
+                    break;
+                }
+                lastMcr = temp;
+
+                command = nextWord(&rest, delim);
+
+                if(command!=NULL){
+                    report("Error: Extraneous text after end of macro definition in file %s.as\n",originFile);
+                    failed=TRUE;
+                    break;
+                }
+
+            }
+
+            /*If the line is a closing macro*/
+            else if (strcmp(command, "endmcro") == TRUE) {
+                mcrFlag=FALSE;
+            }
+
+            /*If the line is inside a macro definition, keeps it in the macro body*/
+            else if(mcrFlag==TRUE){
+                if(addLineToMacro(lastMcr,lineCopy)==FALSE){
+                    noMemory=TRUE;
+                    break;
+                }
+            }
+
+            /*If the line is a line without a macro definition*/
+            else if(mcrFlag==FALSE  && usedMcr == NULL){
+                if(appendStringToBuffer(amText,lineCopy)==FALSE){
+                    noMemory=TRUE;
+                    break;
+                }
+            }
+        }
+        currentLine++;
+    }
+
+    if(noMemory==TRUE){
+        report("Error: cannot allocate memory to preprocess file %s.as\n",originFile);
+        failed=TRUE;
+    }
+
+    /*Frees all allocated memory*/
+    SAFE_FREE(lineCopy)
+    SAFE_FREE(line)
+    if(macros!=NULL)
+        freeMacroTable(macros);
+
+    /*if there was an error, or the file is empty*/
+    if(failed==TRUE || currentLine==1){
+        freeBuffer(amText);
+        return NULL;
+    }
+
+    /*the expanded text of the file*/
+    return amText;
+}
+
+static char* nextWord(char** position, const char* delim){
+    char* word = *position + strspn(*position, delim);
+    size_t length = strcspn(word, delim);
+
+    if(length == 0){
+        *position = word;
+        return NULL;
+    }
+    *position = word + length;
+    if(**position != NULL_TERM)
+        (*position)++;
+    word[length] = NULL_TERM;
+    return word;
+}
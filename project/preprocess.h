@@ -1,9 +1,11 @@
-/**
- * Performs preprocessing on an as file, by deploying macros and creating an am file
- *
- * @param asFileName The name of the as file to preprocess.
- * @param originFile The name of the origin file without any suffix.
- * @return A pointer to the am file that created.
- */
-char* preProcessor(char* asFileName, char* originFile);
-
+#include "buffer.h"
+
+/**
+ * Performs preprocessing on the text of an as file, by deploying macros into the text of the am file
+ *
+ * @param asText The text of the as file to preprocess.
+ * @param originFile The name of the origin file without any suffix.
+ * @return A buffer with the text of the am file (NULL if there was an error or the file is empty).
+ */
+buffer_ptr preProcessor(buffer_ptr asText, char* originFile);
+
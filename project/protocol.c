@@ -0,0 +1,106 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "protocol.h"
+#include "globals.h"
+
+int appendMessage(buffer_ptr buffer, const char* name, const char* value, const char* data, long length){
+    char numbers[64];
+
+    /*The value and the data are both given by their length, so they can have any character (a new line too)*/
+    sprintf(numbers, " %lu %ld\n", (value != NULL) ? (unsigned long) strlen(value) : 0UL, (data != NULL) ? length : 0L);
+    if(appendStringToBuffer(buffer, name)==FALSE || appendStringToBuffer(buffer, numbers)==FALSE)
+        return FALSE;
+    if(value != NULL && appendStringToBuffer(buffer, value)==FALSE)
+        return FALSE;
+    if(appendStringToBuffer(buffer, "\n")==FALSE)
+        return FALSE;
+    if(data != NULL && appendToBuffer(buffer, data, length)==FALSE)
+        return FALSE;
+    return TRUE;
+}
+
+int readMessage(buffer_ptr buffer, long* position, message_ptr msg){
+    char* line = buffer->text + *position;
+    char* end;
+    char* next;
+    long valueLength, left;
+
+    if(*position >= buffer->length)
+        return FALSE;
+    end = (char*) memchr(line, END_OF_LINE, buffer->length - *position);
+    if(end == NULL)
+        return FALSE;
+    *end = NULL_TERM;
+
+    /*The name, and the lengths of the value and of the data*/
+    msg->name = line;
+    next = strchr(line, SPACE_BAR);
+    if(next == NULL)
+        return FALSE;
+    *next++ = NULL_TERM;
+    valueLength = strtol(next, &next, 10);
+    msg->length = strtol(next, &next, 10);
+    left = buffer->length - (end + 1 - buffer->text);
+    if(*next != NULL_TERM || valueLength < 0 || msg->length < 0 || valueLength >= left || msg->length > left - valueLength - 1)
+        return FALSE;
+
+    /*The value is ended by a new line, which is replaced by a null terminator (a value cannot have one of its own)*/
+    msg->value = end + 1;
+    if(msg->value[valueLength] != END_OF_LINE || memchr(msg->value, NULL_TERM, valueLength) != NULL)
+        return FALSE;
+    msg->value[valueLength] = NULL_TERM;
+    msg->data = msg->value + valueLength + 1;
+    *position = (msg->data - buffer->text) + msg->length;
+    return TRUE;
+}
+
+int sendText(int fd, const char* text, long length){
+    while (length > 0) {
+        ssize_t count = write(fd, text, length);
+        if(count < 0 && errno == EINTR)
+            continue;
+        if(count <= 0)
+            return FALSE;
+        text += count;
+        length -= count;
+    }
+    return TRUE;
+}
+
+buffer_ptr receiveText(int fd, long maxLength){
+    buffer_ptr text = createBuffer();
+    ssize_t count;
+
+    if(text==NULL)
+        return NULL;
+
+    /*Reads straight into the buffer until the other side shuts the socket down (a read that times out fails)*/
+    do {
+        if(reserveBuffer(text, PROTOCOL_READ_SIZE)==FALSE){
+            freeBuffer(text);
+            return NULL;
+        }
+        count = read(fd, text->text + text->length, PROTOCOL_READ_SIZE);
+        if(count < 0 && errno == EINTR)
+            continue;
+        if(count < 0){
+            freeBuffer(text);
+            return NULL;
+        }
+        text->length += (long) count;
+
+        /*Stops reading a text that is too long right away*/
+        if(maxLength > 0 && text->length > maxLength){
+            freeBuffer(text);
+            errno = EMSGSIZE;
+            return NULL;
+        }
+    } while (count != 0);
+    text->text[text->length] = NULL_TERM;
+    return text;
+}
@@ -0,0 +1,84 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "buffer.h"
+
+/*The messages between the assembler server and its clients. A client connects to the socket of the server,
+ *sends its request and shuts down its side of the connection, and the server sends the reply and closes it.
+ *Every message is a line "name valueLength dataLength", followed by valueLength bytes of the value and a new line,
+ *and then dataLength bytes of data. Both are given by their length, so a name or a path with a new line in it
+ *does not break the message (a value cannot have a null terminator):
+ *
+ *  request: cwd DIRECTORY            the directory that relative file names are in
+ *           arg ARGUMENT             an argument of the command line (an option or a file name), repeated
+ *           source NAME (data)       the text of the as file of NAME, used instead of reading it (also adds NAME)
+ *  reply:   diagnostics (data)       the messages of the request, exactly as the assembler prints them
+ *           output PATH              an output file that was written (or left as it is), repeated
+ *           done                     the request was done*/
+
+#define PROTOCOL_CWD "cwd"
+#define PROTOCOL_ARG "arg"
+#define PROTOCOL_SOURCE "source"
+#define PROTOCOL_DIAGNOSTICS "diagnostics"
+#define PROTOCOL_OUTPUT "output"
+#define PROTOCOL_DONE "done"
+#define PROTOCOL_SOCKET_ENV "ASSEMBLER_SOCKET" /*The environment variable with the socket of the server*/
+#define PROTOCOL_READ_SIZE 16384 /*The number of bytes a read from the socket asks for at a time*/
+
+/*A message that was read (its strings point into the text it was read from)*/
+typedef struct message * message_ptr;
+typedef struct message{
+
+    /*The name of the message, and its value (an empty string if it has none)*/
+    char* name;
+    char* value;
+
+    /*The data of the message (not null terminated)*/
+    char* data;
+    long length;
+
+}message;
+
+/**
+ * Appends a message to the text of a request or a reply.
+ *
+ * @param buffer The text.
+ * @param name The name of the message.
+ * @param value The value of the message, or NULL if it has none.
+ * @param data The data of the message, or NULL if it has none.
+ * @param length The length of the data.
+ * @return 0 if the message was appended, -1 if memory could not be allocated.
+ */
+int appendMessage(buffer_ptr buffer, const char* name, const char* value, const char* data, long length);
+
+/**
+ * Reads the next message of a request or a reply. The line of the message is cut into its parts in place.
+ *
+ * @param buffer The text.
+ * @param position A pointer to the position in the text, advanced past the message that was read.
+ * @param msg The message to set.
+ * @return 0 if a message was read, -1 at the end of the text (or if the message is broken).
+ */
+int readMessage(buffer_ptr buffer, long* position, message_ptr msg);
+
+/**
+ * Sends text over a socket.
+ *
+ * @param fd The socket.
+ * @param text The text.
+ * @param length The length of the text.
+ * @return 0 if all of the text was sent, -1 otherwise.
+ */
+int sendText(int fd, const char* text, long length);
+
+/**
+ * Receives text from a socket until the other side shuts it down.
+ *
+ * @param fd The socket.
+ * @param maxLength The length of the longest text that is received (0 for no limit).
+ * @return A buffer with the text, or NULL if it cannot be received (errno is EMSGSIZE if the text is longer
+ *         than maxLength, and EAGAIN or EWOULDBLOCK if the socket timed out).
+ */
+buffer_ptr receiveText(int fd, long maxLength);
+
+#endif /* PROTOCOL_H */
@@ -0,0 +1,193 @@
+#include <string.h>
+#include "scan.h"
+#include "globals.h"
+
+/*SSE2 is part of every x86-64 processor, other targets use the portable version*/
+#if defined(__SSE2__) && !defined(SCAN_NO_SIMD)
+#include <emmintrin.h>
+#define SCAN_SIMD
+#endif
+
+#define BLOCK_BITS 0xFFFFu /*A bit for every character of a block*/
+
+/**
+ * Classifies a block of SCAN_BLOCK_SIZE characters.
+ *
+ * @param block The characters to classify.
+ * @param white A pointer to store the bits of the spaces/tabs in.
+ * @param commas A pointer to store the bits of the commas in.
+ * @param quotes A pointer to store the bits of the apostrophes in.
+ * @param ends A pointer to store the bits of the '\n'/'\000' characters in.
+ */
+static void classifyBlock(const char* block, unsigned int* white, unsigned int* commas, unsigned int* quotes, unsigned int* ends);
+
+/**
+ * Gets the bits of the characters of the given classes in a block.
+ *
+ * @param scan The scanned line.
+ * @param block The number of the block.
+ * @param classes The classes of the characters (0 for the characters that are not white).
+ * @return The bits of the characters.
+ */
+static unsigned int blockMask(scan_ptr scan, int block, int classes);
+
+/**
+ * Finds the first character (from the index on) whose bit is set in the masks of the given classes.
+ *
+ * @param scan The scanned line.
+ * @param index The index to start searching from.
+ * @param classes The classes of the characters (0 for the characters that are not white).
+ * @return The index of the character, or the length of the line if there is none.
+ */
+static int findInLine(scan_ptr scan, int index, int classes);
+
+/**
+ * Gets the position of the lowest bit that is set.
+ *
+ * @param mask A mask with at least one bit set.
+ * @return The position of the bit.
+ */
+static int lowestBit(unsigned int mask);
+
+void scanLine(scan_ptr scan, const char* line, int length){
+    char lastBlock[SCAN_BLOCK_SIZE];
+    unsigned int ends;
+    int block, start;
+
+    scan->text = line;
+    scan->length = length;
+
+    for (block = 0, start = 0; start < length; block++, start += SCAN_BLOCK_SIZE) {
+        const char* chars = line + start;
+
+        /*The last block is copied with zero padding, so nothing past the line is read*/
+        if(length - start < SCAN_BLOCK_SIZE){
+            memset(lastBlock, NULL_TERM, SCAN_BLOCK_SIZE);
+            memcpy(lastBlock, chars, length - start);
+            chars = lastBlock;
+        }
+        classifyBlock(chars, &scan->white[block], &scan->commas[block], &scan->quotes[block], &ends);
+
+        /*The line ends at the first '\n' (or '\000')*/
+        if(ends != 0){
+            scan->length = start + lowestBit(ends);
+            return;
+        }
+    }
+}
+
+int findNext(scan_ptr scan, int index, int classes){
+    return findInLine(scan, index, classes);
+}
+
+int skipWhite(scan_ptr scan, int index){
+    return findInLine(scan, index, 0);
+}
+
+int nextToken(scan_ptr scan, int* index, span* token){
+
+    /*Skips the white characters before the token*/
+    *index = skipWhite(scan, *index);
+    if(*index >= scan->length){
+        token->start = NULL;
+        token->length = 0;
+        return FALSE;
+    }
+
+    /*The token ends at the next white character or at the end of the line*/
+    token->start = scan->text + (*index);
+    *index = findNext(scan, *index, SCAN_WHITE);
+    token->length = (int)(scan->text + (*index) - token->start);
+    return TRUE;
+}
+
+static int findInLine(scan_ptr scan, int index, int classes){
+    int block = index / SCAN_BLOCK_SIZE;
+    unsigned int mask;
+
+    if(index >= scan->length)
+        return scan->length;
+
+    /*Ignores the characters of the first block that come before the index*/
+    mask = blockMask(scan, block, classes) & (BLOCK_BITS << (index % SCAN_BLOCK_SIZE));
+    while (mask == 0) {
+        block++;
+        if(block * SCAN_BLOCK_SIZE >= scan->length)
+            return scan->length;
+        mask = blockMask(scan, block, classes);
+    }
+
+    index = block * SCAN_BLOCK_SIZE + lowestBit(mask);
+    return (index < scan->length) ? index : scan->length;
+}
+
+static unsigned int blockMask(scan_ptr scan, int block, int classes){
+    unsigned int mask = 0;
+
+    if(classes == 0)
+        return ~scan->white[block] & BLOCK_BITS;
+    if(classes & SCAN_WHITE)
+        mask |= scan->white[block];
+    if(classes & SCAN_COMMA)
+        mask |= scan->commas[block];
+    if(classes & SCAN_QUOTE)
+        mask |= scan->quotes[block];
+    return mask;
+}
+
+#ifdef SCAN_SIMD
+
+static void classifyBlock(const char* block, unsigned int* white, unsigned int* commas, unsigned int* quotes, unsigned int* ends){
+    __m128i chars = _mm_loadu_si128((const __m128i*) block);
+
+    /*Compares all the characters of the block at once, and keeps a bit for every character*/
+    *white = (unsigned int) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(SPACE_BAR)),
+                                                          _mm_cmpeq_epi8(chars, _mm_set1_epi8(TAB))));
+    *commas = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(COMMA)));
+    *quotes = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(APOSTROPHES)));
+    *ends = (unsigned int) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8(END_OF_LINE)),
+                                                         _mm_cmpeq_epi8(chars, _mm_setzero_si128())));
+}
+
+#else
+
+static void classifyBlock(const char* block, unsigned int* white, unsigned int* commas, unsigned int* quotes, unsigned int* ends){
+    int i;
+
+    /*Sets the bit of every character according to its class*/
+    *white = *commas = *quotes = *ends = 0;
+    for (i = 0; i < SCAN_BLOCK_SIZE; i++) {
+        unsigned int bit = 1u << i;
+        switch (block[i]) {
+            case SPACE_BAR:
+            case TAB:
+                *white |= bit;
+                break;
+            case COMMA:
+                *commas |= bit;
+                break;
+            case APOSTROPHES:
+                *quotes |= bit;
+                break;
+            case END_OF_LINE:
+            case NULL_TERM:
+                *ends |= bit;
+                break;
+        }
+    }
+}
+
+#endif
+
+static int lowestBit(unsigned int mask){
+#ifdef __GNUC__
+    return __builtin_ctz(mask);
+#else
+    int position = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        position++;
+    }
+    return position;
+#endif
+}
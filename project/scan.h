@@ -0,0 +1,73 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "tables.h"
+
+#define SCAN_BLOCK_SIZE 16 /*The number of characters that are classified together*/
+#define SCAN_MAX_BLOCKS ((MAX_LENGTH_LINE_EXTENDED + SCAN_BLOCK_SIZE - 1) / SCAN_BLOCK_SIZE)
+
+/*The classes of the structural characters in a line (may be combined with '|')*/
+#define SCAN_WHITE 1 /*A space or a tab*/
+#define SCAN_COMMA 2 /*A comma*/
+#define SCAN_QUOTE 4 /*An apostrophes*/
+
+/*A line with a bit mask for every class of structural characters in it*/
+typedef struct scannedLine * scan_ptr;
+typedef struct scannedLine{
+
+    /*The text of the line*/
+    const char* text;
+
+    /*The number of characters before the end of the line ('\n' or '\000')*/
+    int length;
+
+    /*A bit for every space/tab, SCAN_BLOCK_SIZE characters in each element*/
+    unsigned int white[SCAN_MAX_BLOCKS];
+
+    /*A bit for every comma, SCAN_BLOCK_SIZE characters in each element*/
+    unsigned int commas[SCAN_MAX_BLOCKS];
+
+    /*A bit for every apostrophes, SCAN_BLOCK_SIZE characters in each element*/
+    unsigned int quotes[SCAN_MAX_BLOCKS];
+
+}scannedLine;
+
+/**
+ * Classifies all the characters of a line in one pass (SSE2 when available, one character at a time otherwise).
+ *
+ * @param scan The scanned line to fill.
+ * @param line The line to scan.
+ * @param length The number of characters in the line (less than MAX_LENGTH_LINE_EXTENDED).
+ */
+void scanLine(scan_ptr scan, const char* line, int length);
+
+/**
+ * Finds the next character of the given classes.
+ *
+ * @param scan The scanned line.
+ * @param index The index to start searching from.
+ * @param classes The classes to search for (SCAN_WHITE/SCAN_COMMA/SCAN_QUOTE).
+ * @return The index of the character, or the length of the line if there is none.
+ */
+int findNext(scan_ptr scan, int index, int classes);
+
+/**
+ * Skips the white characters starting at the given index.
+ *
+ * @param scan The scanned line.
+ * @param index The index to start from.
+ * @return The index of the first character that is not white, or the length of the line if there is none.
+ */
+int skipWhite(scan_ptr scan, int index);
+
+/**
+ * Reads the next token (characters up to a space, tab or end of line) from the line.
+ *
+ * @param scan The scanned line to read from.
+ * @param index A pointer to the index in the line, advanced past the token.
+ * @param token The span of the token that was read (start is NULL if there are no more tokens).
+ * @return 0 if a token was read, -1 if the line ended.
+ */
+int nextToken(scan_ptr scan, int* index, span* token);
+
+#endif /* SCAN_H */
@@ -1,16 +1,22 @@
-#include "firstPass.h"
-
-/**
- * Performs the second pass of the assembly process.
- * Updates the label addresses and ARE values in the instruction words.
- *
- * @param symbol_head The head of the symbol table.
- * @param wordTable_head The head of the word table.
- * @param file The file name.
- */
-void secondPass(symbol_ptr symbol_head, wordTable_ptr wordTable_head, char* file);
-
-
-
-
-
+#include "firstPass.h"
+#include "decode.h"
+
+#define OB_HEADER_MAX_LENGTH 32 /*The maximum length of the first line of the object file (the 2 counters)*/
+#define OUTPUT_LINE_MAX_LENGTH 64 /*The maximum length of a line of the entry and extern files (a label and an address)*/
+
+/**
+ * Performs the second pass of the assembly process.
+ * Updates the label addresses and ARE values in the instruction words.
+ *
+ * @param symbols The symbol table.
+ * @param wordTable_head The head of the word table.
+ * @param file The file name.
+ * @param opts The options given in the command line (which output files to write).
+ * @return 0 if every output file was committed, -1 if one could not be (it is reported by its name).
+ */
+int secondPass(symbolTable_ptr symbols, wordTable_ptr wordTable_head, char* file, options_ptr opts);
+
+
+
+
+
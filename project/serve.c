@@ -0,0 +1,843 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "serve.h"
+#include "commandLine.h"
+#include "protocol.h"
+#include "diagnostics.h"
+#include "outputFile.h"
+#include "fileIO.h"
+#include "threadPool.h"
+#include "utils.h"
+#include "globals.h"
+
+/*An output of a file (its text is NULL if the file should not exist)*/
+typedef struct resultOutput{
+
+    /*The extension of the output file*/
+    char* ext;
+
+    /*The content of the file*/
+    char* text;
+    long length;
+
+}resultOutput;
+
+/*The result of assembling a file*/
+typedef struct fileResult * fileResult_ptr;
+typedef struct fileResult{
+
+    /*The name of the file (as the server sees it), and the options the outputs depend on*/
+    char* file;
+    int outputFlags;
+
+    /*The text of the as file*/
+    char* source;
+    long sourceLength;
+
+    /*The messages of the file (with the name the server sees)*/
+    buffer_ptr diagnostics;
+
+    /*The outputs of the file in the order they were committed*/
+    resultOutput* outputs;
+    int numOfOutputs;
+    int outputsSize;
+
+    /*The results used before and after it (the most recently used result is the first)*/
+    fileResult_ptr previous;
+    fileResult_ptr next;
+
+}fileResult;
+
+/*The results the server keeps, shared by all the threads*/
+typedef struct resultCache * resultCache_ptr;
+typedef struct resultCache{
+
+    pthread_mutex_t lock;
+
+    /*The results from the most recently used to the least*/
+    fileResult_ptr first;
+    fileResult_ptr last;
+    int count;
+
+}resultCache;
+
+/*A connection of a client*/
+typedef struct connection * connection_ptr;
+typedef struct connection{
+
+    /*The socket of the connection*/
+    int fd;
+
+    /*The results of the server*/
+    resultCache_ptr cache;
+
+}connection;
+
+/*A request of a client*/
+typedef struct request * request_ptr;
+typedef struct request{
+
+    /*The directory that relative file names are in (NULL if not sent)*/
+    char* cwd;
+
+    /*The arguments of the command line*/
+    fileList_ptr args;
+
+    /*The sources that were sent instead of read*/
+    message* sources;
+    int numOfSources;
+    int sourcesSize;
+
+}request;
+
+/*Collects the outputs of a file from the output batch*/
+typedef struct outputCollector{
+
+    /*The reply messages of the outputs*/
+    buffer_ptr outputs;
+
+    /*The result to copy the outputs to (NULL if none), and whether it misses some of them*/
+    fileResult_ptr result;
+    int failed;
+
+    /*The length of the file name (the rest of the name of an output is its extension)*/
+    size_t nameLength;
+
+}outputCollector;
+
+/*Set when the server gets a signal to stop*/
+static volatile sig_atomic_t stopRequested = 0;
+
+/**
+ * Asks the server to stop (the handler of SIGINT and SIGTERM).
+ *
+ * @param signalNumber The signal.
+ */
+static void requestStop(int signalNumber);
+
+/**
+ * Finds whether a server is listening on a socket.
+ *
+ * @param address The address of the socket.
+ * @return 0 if a server accepts connections on it, -1 otherwise.
+ */
+static int socketInUse(struct sockaddr_un* address);
+
+/**
+ * Serves a connection: reads the request, does it and sends the reply (a task of the pool).
+ * A request that is longer than SERVE_MAX_REQUEST_SIZE, or whose next part does not come for SERVE_TIMEOUT
+ * seconds, is not done: the reply has an error message and no done message.
+ *
+ * @param arg The connection (freed, and its socket closed).
+ */
+static void serveConnection(void* arg);
+
+/**
+ * Does a request.
+ *
+ * @param cache The results of the server.
+ * @param text The text of the request (cut into its messages in place).
+ * @param reply The text to append the reply to.
+ */
+static void serveRequest(resultCache_ptr cache, buffer_ptr text, buffer_ptr reply);
+
+/**
+ * Reads the messages of a request. A request that does not end with a whole message, or that has
+ * a --files-from argument (the client reads the list), is reported and none of it is done.
+ *
+ * @param req The request to fill (its lists already created).
+ * @param text The text of the request.
+ * @return 0 if the request was read, -1 if it cannot be done (the reason is reported).
+ */
+static int readRequest(request_ptr req, buffer_ptr text);
+
+/**
+ * Assembles a file of a request, or commits its outputs again if its result is kept.
+ *
+ * @param cache The results of the server.
+ * @param req The request.
+ * @param name The name of the file in the request (without as ending).
+ * @param opts The options of the request.
+ * @param diagnostics The messages of the request (the messages of the file are appended).
+ * @param outputs The reply messages of the outputs (the outputs of the file are appended).
+ * @param batch The output batch of the calling thread.
+ */
+static void assembleFile(resultCache_ptr cache, request_ptr req, char* name, options_ptr opts,
+                         buffer_ptr diagnostics, buffer_ptr outputs, outputBatch_ptr batch);
+
+/**
+ * Gets the as text of a file of a request: the source that was sent, or the as file.
+ *
+ * @param req The request.
+ * @param name The name of the file in the request.
+ * @param file The name of the file as the server sees it.
+ * @param text Set to the text, or NULL if the file does not exist.
+ * @return 0 if the text was set, -1 if it is larger than SERVE_MAX_SOURCE_SIZE (it is reported).
+ */
+static int sourceOf(request_ptr req, const char* name, const char* file, buffer_ptr* text);
+
+/**
+ * Resolves a file name of a request against the directory of the request.
+ *
+ * @param cwd The directory (NULL to leave the name as it is).
+ * @param name The name.
+ * @return A new string with the name, or NULL if memory could not be allocated.
+ */
+static char* resolveName(const char* cwd, const char* name);
+
+/**
+ * Appends messages to a buffer, with every appearance of a name replaced by another name.
+ *
+ * @param to The buffer to append to.
+ * @param from The messages.
+ * @param oldName The name to replace.
+ * @param newName The name to put in its place.
+ */
+static void appendRenamed(buffer_ptr to, buffer_ptr from, const char* oldName, const char* newName);
+
+/**
+ * Collects an output of a batch: adds its reply message and copies it to the result (an outputVisitor).
+ *
+ * @param fileName The name of the output file.
+ * @param text The content of the file (NULL if the file should not exist).
+ * @param length The length of the content.
+ * @param arg The collector.
+ */
+static void collectOutput(const char* fileName, const char* text, long length, void* arg);
+
+/**
+ * Creates the result of a file, without messages and outputs yet.
+ *
+ * @param file The name of the file.
+ * @param outputFlags The options the outputs depend on.
+ * @param source The as text (copied).
+ * @return A pointer to the new result, or NULL if memory could not be allocated.
+ */
+static fileResult_ptr createResult(const char* file, int outputFlags, buffer_ptr source);
+
+/**
+ * Adds an output to a result (a copy of its content).
+ *
+ * @param result The result.
+ * @param ext The extension of the output file.
+ * @param text The content of the file (NULL if the file should not exist).
+ * @param length The length of the content.
+ * @return 0 if the output was added, -1 if memory could not be allocated (the caller reports it).
+ */
+static int addResultOutput(fileResult_ptr result, const char* ext, const char* text, long length);
+
+/**
+ * Copies the messages and outputs of a result (without its source).
+ *
+ * @param result The result.
+ * @return A pointer to the copy, or NULL if memory could not be allocated.
+ */
+static fileResult_ptr copyResult(fileResult_ptr result);
+
+/**
+ * Frees a result.
+ *
+ * @param result The result to free.
+ */
+static void freeResult(fileResult_ptr result);
+
+/**
+ * Finds the kept result of a file with the same source and options, and marks it as the most recently used.
+ *
+ * @param cache The results of the server.
+ * @param file The name of the file.
+ * @param outputFlags The options the outputs depend on.
+ * @param source The as text.
+ * @return A copy of the result, or NULL if there is none.
+ */
+static fileResult_ptr findResult(resultCache_ptr cache, const char* file, int outputFlags, buffer_ptr source);
+
+/**
+ * Keeps a result in place of an earlier result of the file, and drops the least recently used results
+ * when there are more than SERVE_CACHE_SIZE.
+ *
+ * @param cache The results of the server.
+ * @param result The result (the cache takes it).
+ */
+static void storeResult(resultCache_ptr cache, fileResult_ptr result);
+
+/**
+ * Puts a result first in the list of the cache (the most recently used).
+ *
+ * @param cache The results of the server.
+ * @param result The result (not in the list).
+ */
+static void linkResult(resultCache_ptr cache, fileResult_ptr result);
+
+/**
+ * Takes a result out of the list of the cache.
+ *
+ * @param cache The results of the server.
+ * @param result The result.
+ */
+static void unlinkResult(resultCache_ptr cache, fileResult_ptr result);
+
+int runServer(const char* socketPath, options_ptr opts){
+    struct sockaddr_un address;
+    struct sigaction action;
+    struct stat status;
+    sigset_t stopSignals, originalMask, waitMask;
+    resultCache cache;
+    threadPool_ptr pool;
+    int listener;
+
+    if(strlen(socketPath) >= sizeof(address.sun_path)){
+        printf("Error: the socket path %s is too long\n", socketPath);
+        return FALSE;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath);
+
+    /*A socket that an earlier server left is replaced (a socket of a running server and other files are not)*/
+    if(stat(socketPath, &status) == 0 && S_ISSOCK(status.st_mode) && socketInUse(&address) == FALSE)
+        unlink(socketPath);
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0 || bind(listener, (struct sockaddr*) &address, sizeof(address)) != 0){
+        printf("Error: cannot listen on the socket %s\n", socketPath);
+        if(listener >= 0)
+            close(listener);
+        return FALSE;
+    }
+    if(listen(listener, SERVE_BACKLOG) != 0){
+        printf("Error: cannot listen on the socket %s\n", socketPath);
+        close(listener);
+        unlink(socketPath);
+        return FALSE;
+    }
+
+    /*SIGINT and SIGTERM are only taken while the server waits for a connection (the threads of the pool,
+     *created after they are blocked, never take them), so a request is never cut in the middle*/
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, &originalMask);
+    waitMask = originalMask;
+    sigdelset(&waitMask, SIGINT);
+    sigdelset(&waitMask, SIGTERM);
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    /*A client that goes away before its reply is sent does not stop the server*/
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, NULL);
+
+    pthread_mutex_init(&cache.lock, NULL);
+    cache.first = NULL;
+    cache.last = NULL;
+    cache.count = 0;
+    pool = createThreadPool(opts->jobs);
+
+    printf("Serving on %s\n", socketPath);
+    fflush(stdout);
+    while (stopRequested == 0) {
+        connection_ptr conn;
+        fd_set ready;
+        int fd;
+
+        FD_ZERO(&ready);
+        FD_SET(listener, &ready);
+        if(pselect(listener + 1, &ready, NULL, NULL, NULL, &waitMask) < 0){
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+        fd = accept(listener, NULL, NULL);
+        if(fd < 0)
+            continue;
+        conn = (connection_ptr) malloc(sizeof(connection));
+        if(conn==NULL){
+            close(fd);
+            report("Error: cannot allocate memory for a connection\n");
+            continue;
+        }
+        conn->fd = fd;
+        conn->cache = &cache;
+        if(pool == NULL || submitTask(pool, serveConnection, conn) == FALSE)
+            serveConnection(conn);
+    }
+
+    /*The requests that were accepted are done before the server stops*/
+    if(pool != NULL){
+        waitForTasks(pool);
+        freeThreadPool(pool);
+    }
+    close(listener);
+    unlink(socketPath);
+    while (cache.first != NULL) {
+        fileResult_ptr result = cache.first;
+        unlinkResult(&cache, result);
+        freeResult(result);
+    }
+    pthread_mutex_destroy(&cache.lock);
+    pthread_sigmask(SIG_SETMASK, &originalMask, NULL);
+    return TRUE;
+}
+
+static void requestStop(int signalNumber){
+    (void) signalNumber;
+    stopRequested = 1;
+}
+
+static int socketInUse(struct sockaddr_un* address){
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int inUse;
+
+    if(fd < 0)
+        return FALSE;
+    inUse = (connect(fd, (struct sockaddr*) address, sizeof(*address)) == 0) ? TRUE : FALSE;
+    close(fd);
+    return inUse;
+}
+
+static void serveConnection(void* arg){
+    connection_ptr conn = (connection_ptr) arg;
+    struct timeval timeout;
+    buffer_ptr text, reply;
+    int receiveError;
+
+    /*A client cannot keep a thread of the server waiting for it*/
+    timeout.tv_sec = SERVE_TIMEOUT;
+    timeout.tv_usec = 0;
+    setsockopt(conn->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(conn->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    text = receiveText(conn->fd, SERVE_MAX_REQUEST_SIZE);
+    receiveError = errno;
+    reply = createBuffer();
+
+    if(text != NULL && reply != NULL){
+        serveRequest(conn->cache, text, reply);
+        sendText(conn->fd, reply->text, reply->length);
+    }
+    else if(reply != NULL && (receiveError == EMSGSIZE || receiveError == EAGAIN || receiveError == EWOULDBLOCK)){
+        char message[128];
+
+        /*The rest of the request is not read, the reply tells the client why*/
+        if(receiveError == EMSGSIZE)
+            sprintf(message, "Error: the request is larger than %ld bytes, the server does not do it\n", SERVE_MAX_REQUEST_SIZE);
+        else
+            sprintf(message, "Error: no part of the request came for %d seconds, the server does not do it\n", SERVE_TIMEOUT);
+        if(appendMessage(reply, PROTOCOL_DIAGNOSTICS, NULL, message, (long) strlen(message)) == TRUE)
+            sendText(conn->fd, reply->text, reply->length);
+    }
+    freeBuffer(text);
+    freeBuffer(reply);
+    close(conn->fd);
+    free(conn);
+}
+
+static void serveRequest(resultCache_ptr cache, buffer_ptr text, buffer_ptr reply){
+    request req;
+    options opts;
+    fileList_ptr files = createFileList();
+    buffer_ptr diagnostics = createBuffer();
+    buffer_ptr outputs = createBuffer();
+    outputBatch_ptr batch = createOutputBatch();
+    int i, done;
+
+    req.cwd = NULL;
+    req.args = createFileList();
+    req.sources = NULL;
+    req.numOfSources = 0;
+    req.sourcesSize = 0;
+    if(files != NULL && diagnostics != NULL && outputs != NULL && batch != NULL && req.args != NULL){
+
+        /*The messages of the request are sent to the client instead of printed*/
+        setDiagnosticsBuffer(diagnostics);
+        setOutputBatch(batch);
+        done = readRequest(&req, text);
+
+        /*The files of a request are assembled one after another (the server does requests at the same time)*/
+        if(done == TRUE){
+            initOptions(&opts);
+            parseArguments(req.args->names, req.args->count, &opts, files);
+            opts.jobs = 1;
+            opts.pipeline = FALSE;
+            opts.serveSocket = NULL;
+            if(files->count == 0)
+                report("No file names provided.\n");
+            for (i = 0; i < files->count; i++)
+                assembleFile(cache, &req, files->names[i], &opts, diagnostics, outputs, batch);
+        }
+
+        /*A request that was not done is answered with its messages only (without a done message)*/
+        setOutputBatch(NULL);
+        setDiagnosticsBuffer(NULL);
+        appendMessage(reply, PROTOCOL_DIAGNOSTICS, NULL, diagnostics->text, diagnostics->length);
+        if(done == TRUE){
+            appendToBuffer(reply, outputs->text, outputs->length);
+            appendMessage(reply, PROTOCOL_DONE, NULL, NULL, 0);
+        }
+    }
+
+    freeFileList(files);
+    freeFileList(req.args);
+    SAFE_FREE(req.sources)
+    freeBuffer(diagnostics);
+    freeBuffer(outputs);
+    freeOutputBatch(batch);
+}
+
+static int readRequest(request_ptr req, buffer_ptr text){
+    message msg;
+    long position = 0;
+
+    while (readMessage(text, &position, &msg) == TRUE) {
+        if(strcmp(msg.name, PROTOCOL_CWD) == 0)
+            req->cwd = msg.value;
+        else if(strcmp(msg.name, PROTOCOL_ARG) == 0){
+
+            /*A list of files is read by the client, not from the files (or the standard input) of the server*/
+            if(strcmp(msg.value, "--files-from") == 0){
+                report("Error: --files-from is read by the client, send the names in it instead\n");
+                return FALSE;
+            }
+            if(addToFileList(req->args, msg.value) == FALSE)
+                return FALSE;
+        }
+        else if(strcmp(msg.name, PROTOCOL_SOURCE) == 0){
+
+            /*Doubles the sources when they are full*/
+            if(req->numOfSources == req->sourcesSize){
+                int newSize = (req->sourcesSize == 0) ? FILE_LIST_INITIAL_SIZE : 2 * req->sourcesSize;
+                message* newSources = (message*) realloc(req->sources, newSize * sizeof(message));
+                if(newSources==NULL){
+                    report("Error: cannot allocate memory to read the request\n");
+                    return FALSE;
+                }
+                req->sources = newSources;
+                req->sourcesSize = newSize;
+            }
+            req->sources[req->numOfSources++] = msg;
+            if(addToFileList(req->args, msg.value) == FALSE)
+                return FALSE;
+        }
+    }
+
+    /*A message that cannot be read (or is cut off) stops the reading before the end of the text*/
+    if(position != text->length){
+        report("Error: malformed request\n");
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void assembleFile(resultCache_ptr cache, request_ptr req, char* name, options_ptr opts,
+                         buffer_ptr diagnostics, buffer_ptr outputs, outputBatch_ptr batch){
+    int outputFlags = ((opts->writeObj == TRUE) ? 1 : 0) | ((opts->writeImage == TRUE) ? 2 : 0) | ((opts->writeHex == TRUE) ? 4 : 0);
+    char* file = resolveName(req->cwd, name);
+    buffer_ptr asText, fileDiagnostics = NULL;
+    fileResult_ptr cached = NULL, result = NULL;
+    outputCollector collector;
+    int i;
+
+    if(file==NULL)return;
+    if(sourceOf(req, name, file, &asText) == FALSE){
+        free(file);
+        return;
+    }
+
+    /*The am file is written as a side effect of assembling, so a file that keeps it is always assembled*/
+    if(asText != NULL && opts->keepAm == FALSE)
+        cached = findResult(cache, file, outputFlags, asText);
+
+    collector.outputs = outputs;
+    collector.result = NULL;
+    collector.failed = FALSE;
+    collector.nameLength = strlen(file);
+    if(cached != NULL){
+
+        /*The outputs are committed again, in case they were changed or removed since*/
+        freeBuffer(asText);
+        for (i = 0; i < cached->numOfOutputs; i++)
+            if(commitOutputFile(file, cached->outputs[i].ext, cached->outputs[i].text, cached->outputs[i].length) == FALSE)
+                collector.failed = TRUE;
+    }
+    else{
+        if(asText != NULL && opts->keepAm == FALSE)
+            result = createResult(file, outputFlags, asText);
+        fileDiagnostics = createBuffer();
+        setDiagnosticsBuffer(fileDiagnostics);
+        decodeSource(file, asText, opts);
+        setDiagnosticsBuffer(diagnostics);
+        collector.result = result;
+    }
+    forEachBatchOutput(batch, collectOutput, &collector);
+
+    /*An output that cannot be written is reported with the messages of the file, and its result is not kept*/
+    if(fileDiagnostics != NULL)
+        setDiagnosticsBuffer(fileDiagnostics);
+    if(flushOutputBatch(batch) == FALSE)
+        collector.failed = TRUE;
+    setDiagnosticsBuffer(diagnostics);
+
+    /*The messages name the file as the client named it*/
+    if(cached != NULL){
+        appendRenamed(diagnostics, cached->diagnostics, file, name);
+        freeResult(cached);
+    }
+    else{
+        if(fileDiagnostics != NULL)
+            appendRenamed(diagnostics, fileDiagnostics, file, name);
+        if(result != NULL && fileDiagnostics != NULL && collector.failed == FALSE){
+            result->diagnostics = fileDiagnostics;
+            storeResult(cache, result);
+        }
+        else{
+            freeBuffer(fileDiagnostics);
+            freeResult(result);
+        }
+    }
+    free(file);
+}
+
+static int sourceOf(request_ptr req, const char* name, const char* file, buffer_ptr* text){
+    char* asFileName;
+    int i;
+
+    *text = NULL;
+    for (i = 0; i < req->numOfSources; i++) {
+        if(strcmp(req->sources[i].value, name) == 0){
+            if(req->sources[i].length > SERVE_MAX_SOURCE_SIZE){
+                report("Error: the file %s is larger than %ld bytes, the server does not assemble it\n", name, SERVE_MAX_SOURCE_SIZE);
+                return FALSE;
+            }
+            *text = createBuffer();
+            if(*text != NULL && appendToBuffer(*text, req->sources[i].data, req->sources[i].length) == FALSE){
+                freeBuffer(*text);
+                *text = NULL;
+            }
+            return TRUE;
+        }
+    }
+
+    asFileName = setOutputFile(file, ".as");
+    if(asFileName==NULL)return TRUE;
+    if(fileSize(asFileName) > SERVE_MAX_SOURCE_SIZE){
+        report("Error: the file %s is larger than %ld bytes, the server does not assemble it\n", name, SERVE_MAX_SOURCE_SIZE);
+        free(asFileName);
+        return FALSE;
+    }
+    *text = readWholeFile(asFileName);
+    free(asFileName);
+    return TRUE;
+}
+
+static char* resolveName(const char* cwd, const char* name){
+    char* resolved;
+
+    if(cwd == NULL || name[0] == '/'){
+        resolved = (char*) malloc(strlen(name) + 1);
+        MALLOC_CHECK(resolved)
+        strcpy(resolved, name);
+        return resolved;
+    }
+    resolved = (char*) malloc(strlen(cwd) + strlen(name) + 2);
+    MALLOC_CHECK(resolved)
+    sprintf(resolved, "%s/%s", cwd, name);
+    return resolved;
+}
+
+static void appendRenamed(buffer_ptr to, buffer_ptr from, const char* oldName, const char* newName){
+    const char* text = from->text;
+    const char* found;
+    size_t oldLength = strlen(oldName);
+
+    if(strcmp(oldName, newName) != 0){
+        while ((found = strstr(text, oldName)) != NULL) {
+            appendToBuffer(to, text, found - text);
+            appendStringToBuffer(to, newName);
+            text = found + oldLength;
+        }
+    }
+    appendToBuffer(to, text, from->text + from->length - text);
+}
+
+static void collectOutput(const char* fileName, const char* text, long length, void* arg){
+    outputCollector* collector = (outputCollector*) arg;
+
+    /*An output without content is a file that was removed, it is not a location of an output*/
+    if(text != NULL)
+        appendMessage(collector->outputs, PROTOCOL_OUTPUT, fileName, NULL, 0);
+    if(collector->result != NULL && addResultOutput(collector->result, fileName + collector->nameLength, text, length) == FALSE){
+        report("Error: cannot allocate memory to keep the output file %s\n", fileName);
+        collector->failed = TRUE;
+    }
+}
+
+static fileResult_ptr createResult(const char* file, int outputFlags, buffer_ptr source){
+    fileResult_ptr result = (fileResult_ptr) calloc(1, sizeof(fileResult));
+
+    if(result==NULL){
+        report("Error: cannot allocate memory to keep the result of %s\n", file);
+        return NULL;
+    }
+    result->file = (char*) malloc(strlen(file) + 1);
+    result->source = (char*) malloc(source->length + 1);
+    if(result->file==NULL || result->source==NULL){
+        freeResult(result);
+        report("Error: cannot allocate memory to keep the result of %s\n", file);
+        return NULL;
+    }
+    strcpy(result->file, file);
+    memcpy(result->source, source->text, source->length);
+    result->sourceLength = source->length;
+    result->outputFlags = outputFlags;
+    return result;
+}
+
+static int addResultOutput(fileResult_ptr result, const char* ext, const char* text, long length){
+    resultOutput* output;
+
+    /*Doubles the outputs when they are full*/
+    if(result->numOfOutputs == result->outputsSize){
+        int newSize = (result->outputsSize == 0) ? OUTPUT_BATCH_INITIAL_SIZE : 2 * result->outputsSize;
+        resultOutput* newOutputs = (resultOutput*) realloc(result->outputs, newSize * sizeof(resultOutput));
+        if(newOutputs==NULL)
+            return FALSE;
+        result->outputs = newOutputs;
+        result->outputsSize = newSize;
+    }
+
+    output = &result->outputs[result->numOfOutputs];
+    output->ext = (char*) malloc(strlen(ext) + 1);
+    output->text = (text != NULL) ? (char*) malloc(length) : NULL;
+    if(output->ext==NULL || (text != NULL && output->text==NULL)){
+        SAFE_FREE(output->ext)
+        SAFE_FREE(output->text)
+        return FALSE;
+    }
+    strcpy(output->ext, ext);
+    if(text != NULL)
+        memcpy(output->text, text, length);
+    output->length = (text != NULL) ? length : 0;
+    result->numOfOutputs++;
+    return TRUE;
+}
+
+static fileResult_ptr copyResult(fileResult_ptr result){
+    fileResult_ptr copy = (fileResult_ptr) calloc(1, sizeof(fileResult));
+    int i;
+
+    if(copy==NULL){
+        report("Error: cannot allocate memory to use the kept result of %s\n", result->file);
+        return NULL;
+    }
+    copy->diagnostics = createBuffer();
+    if(copy->diagnostics==NULL || appendToBuffer(copy->diagnostics, result->diagnostics->text, result->diagnostics->length)==FALSE){
+        freeResult(copy);
+        report("Error: cannot allocate memory to use the kept result of %s\n", result->file);
+        return NULL;
+    }
+    for (i = 0; i < result->numOfOutputs; i++) {
+        if(addResultOutput(copy, result->outputs[i].ext, result->outputs[i].text, result->outputs[i].length)==FALSE){
+            freeResult(copy);
+            report("Error: cannot allocate memory to use the kept result of %s\n", result->file);
+            return NULL;
+        }
+    }
+    copy->outputFlags = result->outputFlags;
+    return copy;
+}
+
+static void freeResult(fileResult_ptr result){
+    int i;
+
+    if(result==NULL)return;
+    for (i = 0; i < result->numOfOutputs; i++) {
+        free(result->outputs[i].ext);
+        SAFE_FREE(result->outputs[i].text)
+    }
+    SAFE_FREE(result->outputs)
+    SAFE_FREE(result->file)
+    SAFE_FREE(result->source)
+    freeBuffer(result->diagnostics);
+    free(result);
+}
+
+static fileResult_ptr findResult(resultCache_ptr cache, const char* file, int outputFlags, buffer_ptr source){
+    fileResult_ptr result, copy = NULL;
+
+    pthread_mutex_lock(&cache->lock);
+    for (result = cache->first; result != NULL; result = result->next) {
+        if(result->outputFlags != outputFlags || strcmp(result->file, file) != 0)
+            continue;
+
+        /*A file has one result for its options, the result of an older source is not used*/
+        if(result->sourceLength == source->length && memcmp(result->source, source->text, source->length) == 0){
+            unlinkResult(cache, result);
+            linkResult(cache, result);
+            copy = copyResult(result);
+        }
+        break;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return copy;
+}
+
+static void storeResult(resultCache_ptr cache, fileResult_ptr result){
+    fileResult_ptr old;
+
+    pthread_mutex_lock(&cache->lock);
+    for (old = cache->first; old != NULL; old = old->next) {
+        if(old->outputFlags == result->outputFlags && strcmp(old->file, result->file) == 0){
+            unlinkResult(cache, old);
+            freeResult(old);
+            break;
+        }
+    }
+
+    linkResult(cache, result);
+    while (cache->count > SERVE_CACHE_SIZE) {
+        old = cache->last;
+        unlinkResult(cache, old);
+        freeResult(old);
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static void linkResult(resultCache_ptr cache, fileResult_ptr result){
+    result->previous = NULL;
+    result->next = cache->first;
+    if(cache->first != NULL)
+        cache->first->previous = result;
+    cache->first = result;
+    if(cache->last == NULL)
+        cache->last = result;
+    cache->count++;
+}
+
+static void unlinkResult(resultCache_ptr cache, fileResult_ptr result){
+    if(result->previous != NULL)
+        result->previous->next = result->next;
+    else
+        cache->first = result->next;
+    if(result->next != NULL)
+        result->next->previous = result->previous;
+    else
+        cache->last = result->previous;
+    result->previous = NULL;
+    result->next = NULL;
+    cache->count--;
+}
@@ -0,0 +1,26 @@
+#ifndef SERVE_H
+#define SERVE_H
+
+#include "decode.h"
+
+/*The assembler as a server: it listens on a Unix domain socket, and assembles the files of every request
+ *(see protocol.h) on a pool of threads, one request on every thread. The result of every file (its messages
+ *and outputs) is kept, and a file that is sent again with the same source and options is not assembled again:
+ *its outputs are committed again (so outputs that were removed are back) and its messages are sent as they were.*/
+
+#define SERVE_CACHE_SIZE 256 /*The number of file results the server keeps (the least recently used is dropped)*/
+#define SERVE_BACKLOG 64 /*The number of connections that can wait for the server to accept them*/
+#define SERVE_MAX_REQUEST_SIZE (64L * 1024 * 1024) /*The largest request the server reads (a larger one is rejected)*/
+#define SERVE_MAX_SOURCE_SIZE (16L * 1024 * 1024) /*The largest as file (sent or read) the server assembles*/
+#define SERVE_TIMEOUT 30 /*The number of seconds the server waits for a client to send (or read) the next part*/
+
+/**
+ * Serves the requests of clients on a socket, until the server gets SIGINT or SIGTERM.
+ *
+ * @param socketPath The path of the socket (a socket an earlier server left there is replaced).
+ * @param opts The options given in the command line (opts->jobs requests are done at the same time).
+ * @return 0 if the server ran and was stopped, -1 if it could not listen on the socket.
+ */
+int runServer(const char* socketPath, options_ptr opts);
+
+#endif /* SERVE_H */
@@ -1,275 +1,266 @@
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-#include "tables.h"
-#include "globals.h"
-
-
-void initializeInsWord(wordIns_ptr word){
-
-    /*Initializes variables to certain values*/
-    word->isLabel=FALSE;
-    word->address=0;
-    word->hasLabel=FALSE;
-    memset(word->labelName,NULL_TERM,MAX_LABEL_SIZE);
-    memset(word->binCode,0,WORD_NUM_OF_BITS);
-    word->next=NULL;
-}
-
-void initializeDirWord(wordDir_ptr word){
-
-    /*Initializes variables to certain values*/
-    word->address=0;
-    word->hasLabel=FALSE;
-    memset(word->labelName,NULL_TERM,MAX_LABEL_SIZE);
-    memset(word->binCode,0,WORD_NUM_OF_BITS);
-    word->next=NULL;
-}
-
-void initializeSt(st_ptr st){
-
-    /*Initializes variables to certain values*/
-    int i;
-    st->hasLabel=FALSE;
-    st->sentenceType=FALSE;
-    st->directiveType=FALSE;
-    st->opcode=FALSE;
-    st->numOfOperands=0;
-    st->sourceOpType=0;
-    st->sourceOp=0;
-    st->destOpType=0;
-    st->destOp=0;
-    st->sourceAdrMethod=0;
-    st->destAdrMethod=0;
-    for (i = 0; i < MAX_LENGTH_LINE; i++)
-        st->directive.Data.numArr[i] = NUM_OUT_OF_RANGE;
-}
-
-symbol_ptr searchForSymbol(symbol_ptr* head,char* symbolName){
-
-    /*Searches for a symbol in a symbol table and returns its address (if found)*/
-    symbol_ptr temp = *head;
-    while (temp!=NULL){
-        if(strcmp(temp->name,symbolName)==TRUE)
-            return temp;
-        temp=temp->next;
-    }
-    return NULL;
-}
-
-void addToSymbolTable(symbol_ptr* head, symbol_ptr newSymbol) {
-
-    /*Adds a symbol to the symbol table*/
-    symbol_ptr temp = *head;
-    newSymbol->next=NULL;
-    if (temp == NULL) {
-        *head = newSymbol;
-        (*head)->next = NULL;
-    } else {
-        while (temp->next != NULL)
-            temp = temp->next;
-        temp->next = newSymbol;
-    }
-}
-
-symbol_ptr createNewSymbol(char* name,int type){
-
-    /*Creates a new symbol, initializes its variables and returns its address*/
-    symbol_ptr newSymbol  = (symbol_ptr)malloc(sizeof(symbolTable));
-    if(newSymbol==NULL){ printf("cannot allocate memory");return NULL;}
-    strcpy(newSymbol->name,name);
-    newSymbol->address=0;
-    newSymbol->type=type;
-    newSymbol->next=NULL;
-    return newSymbol;
-}
-
-void addToStTable(st_ptr* head, st_ptr st) {
-    st_ptr temp = *head;
-    st->next=NULL;
-
-    /*Adds a st to the st table*/
-    if (temp == NULL) {
-        *head = st;
-        (*head)->next = NULL;
-    } else {
-        while (temp->next != NULL)
-            temp = temp->next;
-        temp->next = st;
-    }
-}
-
-void addToInsWordTable(wordIns_ptr * head, wordIns_ptr word){
-    wordIns_ptr temp = *head;
-    word->next=NULL;
-
-    /*Inserts an instruction word into an instruction word table*/
-    if (temp == NULL) {
-        *head = word;
-        (*head)->next = NULL;
-    } else {
-        while (temp->next != NULL)
-            temp = temp->next;
-        temp->next = word;
-    }
-}
-
-
-
-void addToDirWordTable(wordDir_ptr * head, wordDir_ptr word){
-    wordDir_ptr temp = *head;
-
-    word->next=NULL;
-
-    /*Inserts an directive word into an directive word table*/
-    if (temp == NULL) {
-        *head = word;
-        (*head)->next = NULL;
-    } else {
-        while (temp->next != NULL)
-            temp = temp->next;
-        temp->next = word;
-    }
-}
-
-
-
-void freeStTable(st_ptr head){
-    st_ptr temp;
-
-    /*Frees all st table nodes*/
-    while (head!=NULL){
-        temp=head;
-        head=head->next;
-        free(temp);
-    }
-}
-
-void freeSymbolTable(symbol_ptr head){
-    symbol_ptr temp;
-
-    /*Frees all symbol table nodes*/
-    while (head!=NULL){
-        temp=head;
-        head=head->next;
-        free(temp);
-    }
-}
-
-void freeInsTable(wordIns_ptr head){
-    wordIns_ptr temp;
-
-    /*Frees all Instruction table nodes*/
-    while (head!=NULL){
-        temp=head;
-        head=head->next;
-        free(temp);
-    }
-}
-
-void freeDirTable(wordDir_ptr head){
-    wordDir_ptr temp;
-
-    /*Frees all Directive table nodes*/
-    while (head!=NULL){
-        temp=head;
-        head=head->next;
-        free(temp);
-    }
-}
-
-void freeWordsTable(wordTable_ptr head){
-    wordIns_ptr insHead;
-    wordDir_ptr dirHead;
-    wordIns_ptr tempInsWord;
-    wordDir_ptr tempDirWord;
-
-    /*In case of  an error in the first pass, will be NULL*/
-    if(head==NULL)return;
-
-    insHead = head->ins_head;
-    dirHead = head->dir_head;
-
-    /*Frees the table of instruction and directive words*/
-    while (insHead!=NULL){
-        tempInsWord=insHead;
-        insHead=insHead->next;
-        free(tempInsWord);
-    }
-    while (dirHead!=NULL){
-        tempDirWord=dirHead;
-        dirHead=dirHead->next;
-        free(tempDirWord);
-    }
-
-    /*Releases the node allocated to hold the pointers to the tables*/
-    free(head);
-}
-
-void printMacroToFile(FILE* program,FILE* newFile, int macroIndex,macroPtr head){
-    int i,currentLine=1;
-    char* line;
-    macroPtr pMcr = head;
-
-    line = (char *) malloc(MAX_LENGTH_LINE_EXTENDED);
-    fseek(program, 0, SEEK_SET);
-
-    if (line == NULL) {
-        printf("\ncannot allocated memory\n");
-        exit(1);
-    }
-
-    /*Advances the pointer to point to the link of the right macro*/
-    for (i = 0; i < macroIndex; i++)
-        pMcr=pMcr->next;
-
-    /*Prints to the am file the lines that the macro contains, excluding blank lines or comment lines*/
-    while (fgets(line, MAX_LENGTH_LINE_EXTENDED, program)){
-        if(currentLine>=pMcr->startLine && currentLine<=pMcr->endingLine)
-        {
-
-            /*Checks whether the line is an empty line or a comment line*/
-            char firstChar = '\0';
-            for (i = 0; line[i] != '\0'; i++) {
-                if (!isspace(line[i])) {
-                    firstChar = line[i];
-                    break;
-                }
-            }
-
-            /*Prints the line to the file*/
-            if(firstChar!=END_OF_LINE && firstChar!=COMMENT)
-                fprintf(newFile, "%s", line);
-        }
-        currentLine++;
-    }
-
-    /*Releases the memory allocated to the line*/
-    free(line);
-}
-
-int isMacro(macroPtr head,const char name[]){
-    int index=0;
-    macroPtr temp=head;
-
-    /*Goes through the macro table and checks if a macro exists*/
-    while (temp!=NULL){
-        if(strcmp(temp->name,name)==TRUE)
-            return index;
-        temp=temp->next;
-        index++;
-    }
-    return FALSE;
-}
-
-void freeMacroTable(macroPtr head){
-    macroPtr temp;
-
-    /*Frees all macro table nodes*/
-    while (head!=NULL){
-        temp=head;
-        head=head->next;
-        free(temp->name);
-        free(temp);
-    }
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "tables.h"
+#include "globals.h"
+#include "utils.h"
+
+/**
+ * Doubles the number of buckets in the macro table and moves every macro to its new bucket.
+ *
+ * @param table The macro table.
+ * @return 0 if the table was resized, -1 if memory could not be allocated.
+ */
+static int resizeMacroTable(macroTable_ptr table);
+
+/**
+ * Finds the slot of a name in the symbol table.
+ *
+ * @param table The symbol table.
+ * @param name The name of the symbol.
+ * @return The index of the slot that holds the name, or of the empty slot where it would be inserted.
+ */
+static int findSymbolSlot(symbolTable_ptr table, const char* name);
+
+/**
+ * Doubles the number of slots in the symbol table and moves every symbol to its new slot.
+ *
+ * @param table The symbol table.
+ * @return 0 if the table was resized, -1 if memory could not be allocated.
+ */
+static int resizeSymbolTable(symbolTable_ptr table);
+
+
+void initializeSt(st_ptr st){
+
+    /*Initializes variables to certain values*/
+    st->label.start=NULL;
+    st->label.length=0;
+    st->symbol=NULL;
+    st->sentenceType=FALSE;
+    st->directiveType=FALSE;
+    st->opcode=FALSE;
+    st->numOfOperands=0;
+    st->source.label.start=NULL;
+    st->source.label.length=0;
+    st->source.value=0;
+    st->source.type=0;
+    st->source.adrMethod=0;
+    st->dest=st->source;
+    st->directive.numbers=NULL;
+    st->count=0;
+}
+
+symbolTable_ptr createSymbolTable(arena_ptr arena){
+
+    /*Creates an empty symbol table with all the slots empty*/
+    symbolTable_ptr table = (symbolTable_ptr) arenaAlloc(arena, sizeof(symbolTable));
+    if(table==NULL)return NULL;
+    table->slots = (symbol_ptr*) arenaAlloc(arena, SYMBOL_TABLE_INITIAL_SIZE * sizeof(symbol_ptr));
+    if(table->slots==NULL)return NULL;
+    memset(table->slots, 0, SYMBOL_TABLE_INITIAL_SIZE * sizeof(symbol_ptr));
+    table->arena = arena;
+    table->numOfSlots = SYMBOL_TABLE_INITIAL_SIZE;
+    table->count = 0;
+    table->head = table->tail = NULL;
+    table->externalHead = table->externalTail = NULL;
+    return table;
+}
+
+static int findSymbolSlot(symbolTable_ptr table, const char* name){
+
+    /*Goes over the slots from the slot of the hash until the name or an empty slot is found*/
+    int index = (int)(hashString(name) & (table->numOfSlots - 1));
+    while (table->slots[index]!=NULL && strcmp(table->slots[index]->name,name)!=TRUE)
+        index = (index + 1) & (table->numOfSlots - 1);
+    return index;
+}
+
+static int resizeSymbolTable(symbolTable_ptr table){
+    int i, newNumOfSlots = table->numOfSlots * 2;
+    symbol_ptr* oldSlots = table->slots;
+    symbol_ptr* newSlots = (symbol_ptr*) arenaAlloc(table->arena, newNumOfSlots * sizeof(symbol_ptr));
+    if(newSlots==NULL)return FALSE;
+    memset(newSlots, 0, newNumOfSlots * sizeof(symbol_ptr));
+
+    /*Moves every symbol from the old slots to the new ones (the old slots stay in the arena)*/
+    table->slots = newSlots;
+    table->numOfSlots = newNumOfSlots;
+    for (i = 0; i < newNumOfSlots / 2; i++)
+        if(oldSlots[i]!=NULL)
+            newSlots[findSymbolSlot(table,oldSlots[i]->name)] = oldSlots[i];
+    return TRUE;
+}
+
+symbol_ptr addSymbol(symbolTable_ptr table, const char* name, int type){
+    symbol_ptr newSymbol;
+    int index = findSymbolSlot(table,name);
+
+    /*A name that is already in the table gets another flag*/
+    newSymbol = table->slots[index];
+    if(newSymbol!=NULL)
+        newSymbol->flags |= SYMBOL_FLAG(type);
+
+    /*A new name gets a new symbol at the end of the order*/
+    else{
+        newSymbol = (symbol_ptr) arenaAlloc(table->arena, sizeof(symbol));
+        if(newSymbol==NULL)return NULL;
+        strcpy(newSymbol->name,name);
+        newSymbol->address=0;
+        newSymbol->flags=SYMBOL_FLAG(type);
+        newSymbol->firstFixup=NULL;
+        newSymbol->lastFixup=NULL;
+        newSymbol->next=NULL;
+        newSymbol->nextExternal=NULL;
+        table->slots[index] = newSymbol;
+        table->count++;
+        if(table->tail==NULL)
+            table->head = newSymbol;
+        else
+            table->tail->next = newSymbol;
+        table->tail = newSymbol;
+
+        /*Keeps at least half of the slots empty, so the searches stay short*/
+        if(table->count * 2 > table->numOfSlots && resizeSymbolTable(table)==FALSE)
+            return NULL;
+    }
+
+    /*The external symbols are also kept in the order they were defined as external*/
+    if(type==external){
+        if(table->externalTail==NULL)
+            table->externalHead = newSymbol;
+        else
+            table->externalTail->nextExternal = newSymbol;
+        table->externalTail = newSymbol;
+    }
+    return newSymbol;
+}
+
+symbol_ptr searchForSymbol(symbolTable_ptr table, const char* symbolName){
+
+    /*Searches for a symbol in a symbol table and returns its address (if found)*/
+    return table->slots[findSymbolSlot(table,symbolName)];
+}
+
+int addLineToMacro(macroPtr mcr, const char* line){
+    int i;
+
+    /*Checks whether the line is an empty line or a comment line*/
+    char firstChar = '\0';
+    for (i = 0; line[i] != '\0'; i++) {
+        if (!isspace(line[i])) {
+            firstChar = line[i];
+            break;
+        }
+    }
+
+    /*Only lines with content are kept in the macro body*/
+    if(firstChar==NULL_TERM || firstChar==COMMENT)
+        return TRUE;
+    return appendStringToBuffer(mcr->body,line);
+}
+
+macroTable_ptr createMacroTable(void){
+
+    /*Creates an empty macro table with all the buckets empty*/
+    macroTable_ptr table = (macroTable_ptr) malloc(sizeof(macroTable));
+    if(table==NULL)
+        return NULL;
+    table->buckets = (macroPtr*) calloc(MACRO_TABLE_INITIAL_SIZE, sizeof(macroPtr));
+    if(table->buckets==NULL){
+        free(table);
+        return NULL;
+    }
+    table->numOfBuckets = MACRO_TABLE_INITIAL_SIZE;
+    table->count = 0;
+    table->lengths = 0;
+    memset(table->firstChars, 0, CHAR_BITMAP_SIZE);
+    return table;
+}
+
+static int resizeMacroTable(macroTable_ptr table){
+    int i, newNumOfBuckets = table->numOfBuckets * 2;
+    macroPtr* newBuckets = (macroPtr*) calloc(newNumOfBuckets, sizeof(macroPtr));
+    if(newBuckets==NULL)
+        return FALSE;
+
+    /*Moves every macro from the old buckets to the end of the new ones, keeping their order*/
+    for (i = 0; i < table->numOfBuckets; i++) {
+        macroPtr temp = table->buckets[i];
+        while (temp!=NULL){
+            macroPtr next = temp->next;
+            macroPtr* end = &newBuckets[hashString(temp->name) % newNumOfBuckets];
+            while (*end!=NULL)
+                end = &(*end)->next;
+            temp->next = NULL;
+            *end = temp;
+            temp = next;
+        }
+    }
+    free(table->buckets);
+    table->buckets = newBuckets;
+    table->numOfBuckets = newNumOfBuckets;
+    return TRUE;
+}
+
+int addToMacroTable(macroTable_ptr table, macroPtr mcr){
+    macroPtr* end;
+    unsigned char firstChar = (unsigned char)mcr->name[0];
+    size_t length = strlen(mcr->name);
+
+    /*Keeps about one macro per bucket*/
+    if(table->count >= table->numOfBuckets && resizeMacroTable(table)==FALSE)
+        return FALSE;
+
+    /*Inserts the macro at the end of its bucket, so the first definition of a name is the one found*/
+    end = &table->buckets[hashString(mcr->name) % table->numOfBuckets];
+    while (*end!=NULL)
+        end = &(*end)->next;
+    mcr->next = NULL;
+    *end = mcr;
+    table->count++;
+
+    /*Marks the first char and the length of the name in the filters*/
+    table->firstChars[firstChar / 8] |= (unsigned char)(1 << (firstChar % 8));
+    table->lengths |= 1UL << (length < 31 ? length : 31);
+    return TRUE;
+}
+
+macroPtr searchForMacro(macroTable_ptr table, const char* name){
+    macroPtr temp;
+    unsigned char firstChar = (unsigned char)name[0];
+    size_t length = strlen(name);
+
+    /*Most lines are not macros, so they are filtered out without hashing*/
+    if(!(table->firstChars[firstChar / 8] & (1 << (firstChar % 8))) ||
+       !(table->lengths & (1UL << (length < 31 ? length : 31))))
+        return NULL;
+
+    /*Goes through the macros in the bucket of the name*/
+    temp = table->buckets[hashString(name) % table->numOfBuckets];
+    while (temp!=NULL){
+        if(strcmp(temp->name,name)==TRUE)
+            return temp;
+        temp=temp->next;
+    }
+    return NULL;
+}
+
+void freeMacroTable(macroTable_ptr table){
+    int i;
+    macroPtr temp;
+
+    /*Frees all the macros in every bucket, then the table itself*/
+    for (i = 0; i < table->numOfBuckets; i++) {
+        macroPtr head = table->buckets[i];
+        while (head!=NULL){
+            temp=head;
+            head=head->next;
+            free(temp->name);
+            freeBuffer(temp->body);
+            free(temp);
+        }
+    }
+    free(table->buckets);
+    free(table);
 }
\ No newline at end of file
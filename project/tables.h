@@ -1,318 +1,325 @@
-#ifndef TABLES_H
-#define TABLES_H
-
-#include <stdio.h>
-
-#define MAX_LENGTH_LINE_EXTENDED 200 /*Maximum line length before valid line length check*/
-#define MAX_LENGTH_LINE 81 /*include '\n' and '\000' at the end*/
-#define MAX_LABEL_SIZE 31 /*include '\000' at the end*/
-#define WORD_NUM_OF_BITS 12 /*Number of bits of a word*/
-#define NUM_OUT_OF_RANGE 5000 /*An out-of-range number used to check for a stop condition*/
-
-/*Word table for instruction words*/
-typedef struct wordIns * wordIns_ptr;
-typedef struct wordIns{
-
-    /*The binary representation of the word*/
-    int binCode[WORD_NUM_OF_BITS];
-
-    /*Is the word of a label*/
-    int hasLabel;
-
-    /*Is the word of a label*/
-    int isLabel;
-
-    /*The label for which the word was created*/
-    char labelName[MAX_LABEL_SIZE];
-
-    /*The word address*/
-    int address;
-
-    /*Pointer to the next word*/
-    wordIns_ptr next;
-
-} wordIns;
-
-/*Word table for directive words*/
-typedef struct wordDir * wordDir_ptr;
-typedef struct wordDir{
-
-    /*The binary representation of the word*/
-    int binCode[WORD_NUM_OF_BITS];
-
-    /*Is the word of a label*/
-    int hasLabel;
-
-    /*The label for which the word was created*/
-    char labelName[MAX_LABEL_SIZE];
-
-    /*The word address*/
-    int address;
-
-    /*Pointer to the next word*/
-    wordDir_ptr next;
-
-} wordDir;
-
-/*A structure that holds the instructions and directive counter,
- *and points to the head of the instructions table and the directive table*/
-typedef struct wordTable * wordTable_ptr;
-typedef struct wordTable{
-
-    /*Pointer to the head of an instruction table*/
-    wordIns_ptr ins_head;
-
-    /*Pointer to the head of an directive table*/
-    wordDir_ptr dir_head;
-
-    /*instruction counter*/
-    int IC;
-
-    /*directive counter*/
-    int DC;
-
-} wordTable;
-
-/*Macro table for macros*/
-typedef struct macro * macroPtr;
-typedef struct macro{
-
-    /*The name of the macro*/
-    char* name;
-
-    /*The line that the macro starts*/
-    int startLine;
-
-    /*The line that the macro ends*/
-    int endingLine;
-
-    /*Pointer to the next macro*/
-    macroPtr next;
-
-}macro;
-
-/*Symbol table for symbols*/
-typedef struct symbolTable * symbol_ptr;
-typedef struct symbolTable{
-
-    /*The name of the symbol*/
-    char name[MAX_LABEL_SIZE];
-
-    /*The address of the symbol*/
-    int address;
-
-    /*The symbol type (defined in file/entry/external)*/
-    int type;
-
-    /*Pointer to the next symbol*/
-    symbol_ptr next;
-
-}symbolTable;
-
-/*sentenceTree table for sentenceTree node (each node represent a line)*/
-typedef struct sentenceTree * st_ptr;
-typedef struct sentenceTree{
-
-    /*The name of the label defined in the row (if any)*/
-    char label[MAX_LABEL_SIZE];
-
-    /*Has a label been added to the line*/
-    unsigned short hasLabel;
-
-    /*Line type (instruction line/ Directive line)*/
-    unsigned short sentenceType;
-
-    /*for directive sentence*/
-
-    /*Directive type (DATA/STRING/ENTRY/EXTERN)*/
-    unsigned short directiveType;
-    union {
-        struct dataDirective {
-
-            /*An array that holds legal numbers defined in the directive*/
-            int numArr[MAX_LENGTH_LINE];
-
-        } Data;
-        struct stringDirective {
-
-            /*An array that holds a legal string defined in the directive*/
-            char str[MAX_LENGTH_LINE];
-
-        } String;
-    } directive;
-
-    /*for instruction sentence*/
-
-    /*A number that represents an opcode type*/
-    unsigned short opcode;
-
-    /*The number of operands according to the opcode*/
-    unsigned short numOfOperands;
-
-    /*operand type if present (number/label/register)*/
-    unsigned short sourceOpType;
-
-    /*In case the operand is a number or a register, represent the number or the register number*/
-    int sourceOp;
-
-    /*operand type if present (number/label/register)*/
-    unsigned short destOpType;
-
-    /*In case the operand is a number or a register, represent the number or the register number*/
-    int destOp;
-
-    /*In case and the source operand is a label*/
-    char sourceOpLabel[MAX_LABEL_SIZE];
-
-    /*In case and the destination operand is a label*/
-    char destOpLabel[MAX_LABEL_SIZE];
-
-    /*The addressing method for the source operand*/
-    unsigned short sourceAdrMethod;
-
-    /*The addressing method for the destination operand*/
-    unsigned short destAdrMethod;
-
-    /*points to the next node*/
-    st_ptr next;
-
-    /*Pointer to the head of the symbol table*/
-    symbol_ptr symbol_head;
-
-}sentenceTree;
-
-
-/**
- * Adds a symbol to the symbol table.
- *
- * @param head A pointer to the head of the symbol table.
- * @param newSymbol The symbol to be added.
- */
-void addToSymbolTable(symbol_ptr* head, symbol_ptr newSymbol);
-
-/**
- * Creates a new symbol with the specified name and type.
- *
- * @param name The name of the symbol.
- * @param type The type of the symbol.
- * @return A pointer to the newly created symbol.
- */
-symbol_ptr createNewSymbol(char* name, int type);
-
-/**
- * Adds a st node to the st table.
- *
- * @param head A pointer to the head of the st table.
- * @param st The st node to be added.
- */
-void addToStTable(st_ptr* head, st_ptr st);
-
-/**
- * Searches for a symbol in the symbol table by name.
- *
- * @param head A pointer to the head of the symbol table.
- * @param symbolName The name of the symbol to search for.
- * @return A pointer to the found symbol, or NULL if not found.
- */
-symbol_ptr searchForSymbol(symbol_ptr* head, char* symbolName);
-
-/**
- * Initializes a st node.
- *
- * @param st The st node to be initialized.
- */
-void initializeSt(st_ptr st);
-
-/**
- * Adds an instruction word to the instruction word table.
- *
- * @param head A pointer to the head of the instruction word table.
- * @param word The instruction word to be added.
- */
-void addToInsWordTable(wordIns_ptr* head, wordIns_ptr word);
-
-/**
- * Adds a directive word to the directive word table.
- *
- * @param head A pointer to the head of the directive word table.
- * @param word The directive word to be added.
- */
-void addToDirWordTable(wordDir_ptr* head, wordDir_ptr word);
-
-/**
- * Frees the memory allocated for the st table.
- *
- * @param head The head of the st table.
- */
-void freeStTable(st_ptr head);
-
-/**
- * Frees the memory allocated for the symbol table.
- *
- * @param head The head of the symbol table.
- */
-void freeSymbolTable(symbol_ptr head);
-
-/**
- * Frees the memory allocated for the word table.
- *
- * @param head The head of the words table.
- */
-void freeWordsTable(wordTable_ptr head);
-
-/**
- * Checks if a given macro name exists in a macro table.
- *
- * @param head The head pointer of the macro table.
- * @param name The name of the macro to search for.
- * @return 1 if the macro exists in the table, 0 otherwise.
- */
-int isMacro(macroPtr head, const char name[]);
-
-/**
- * Prints the content of a macro at a specific index to a file.
- *
- * @param program The file pointer of the original program.
- * @param newFile The file pointer of the new file to write the macro content to.
- * @param macroIndex The index of the macro to print.
- * @param head The head pointer of the macro table.
- */
-void printMacroToFile(FILE* program, FILE* newFile, int macroIndex, macroPtr head);
-
-/**
- * Frees the memory occupied by the macro table.
- *
- * @param head The head pointer of the macro table.
- */
-void freeMacroTable(macroPtr head);
-
-/**
- * Frees instruction table
- *
- * @param head The head of the instruction table.
- */
-void freeInsTable(wordIns_ptr head);
-
-/**
- * Frees instruction table
- *
- * @param head The head of the directive table.
- */
-void freeDirTable(wordDir_ptr head);
-
-/**
- * Initializes a wordIns node.
- *
- * @param word The word node to be initialized.
- */
-void initializeInsWord(wordIns_ptr word);
-
-/**
- * Initializes a wordDir node.
- *
- * @param word The word node to be initialized.
- */
-void initializeDirWord(wordDir_ptr word);
-
-#endif /* TABLES_H */
-
+#ifndef TABLES_H
+#define TABLES_H
+
+#include <stdio.h>
+#include "buffer.h"
+#include "arena.h"
+
+#define MAX_LENGTH_LINE_EXTENDED 200 /*Maximum line length before valid line length check*/
+#define MAX_LENGTH_LINE 81 /*include '\n' and '\000' at the end*/
+#define MAX_LABEL_SIZE 31 /*The maximum length of a label (without the '\000' at the end)*/
+#define WORD_NUM_OF_BITS 12 /*Number of bits of a word*/
+#define WORD_MASK 0xFFF /*The bits of a word*/
+
+/*The ARE (Absolute/Relocatable/External) field of a word*/
+#define ARE_ABSOLUTE 0
+#define ARE_EXTERNAL 1
+#define ARE_RELOCATABLE 2
+
+/*The fields of a word, each shifted to its bits (bits 0-1 are the ARE of every word)*/
+#define ENCODE_ARE(are) ((are) & 0x3)
+#define ENCODE_DEST_ADR(method) (((method) & 0x7) << 2) /*first word: bits 2-4*/
+#define ENCODE_OPCODE(opcode) (((opcode) & 0xF) << 5) /*first word: bits 5-8*/
+#define ENCODE_SOURCE_ADR(method) (((method) & 0x7) << 9) /*first word: bits 9-11*/
+#define ENCODE_VALUE(value) (((value) & 0x3FF) << 2) /*a number or a label address: bits 2-11*/
+#define ENCODE_DEST_REG(reg) (((reg) & 0x1F) << 2) /*registers word: bits 2-6*/
+#define ENCODE_SOURCE_REG(reg) (((reg) & 0x1F) << 7) /*registers word: bits 7-11*/
+#define MACRO_TABLE_INITIAL_SIZE 64 /*The initial number of buckets in the macro table*/
+#define CHAR_BITMAP_SIZE 32 /*Number of bytes needed for a bitmap with a bit for every char*/
+#define SYMBOL_TABLE_INITIAL_SIZE 64 /*The initial number of slots in the symbol table (a power of 2)*/
+#define SYMBOL_FLAG(type) (1 << (type)) /*The flag of a label definition type (external/relocatable/entry)*/
+#define SYMBOL_DEFINED SYMBOL_FLAG(relocatable) /*The symbol is defined by a label in the file*/
+#define SYMBOL_EXTERNAL SYMBOL_FLAG(external) /*The symbol is declared .extern*/
+#define SYMBOL_ENTRY SYMBOL_FLAG(entry) /*The symbol is declared .entry*/
+#define SYMBOL_DATA (1 << 3) /*The symbol is defined at a data word (its address is relocated after the code)*/
+
+/*A symbol (label) of the program, one for every name*/
+typedef struct symbol * symbol_ptr;
+
+/*A label operand of an instruction, its word is filled in the second pass*/
+typedef struct fixup * fixup_ptr;
+typedef struct fixup{
+
+    /*The index of the word in the code*/
+    int index;
+
+    /*The symbol of the label (NULL if the label is not defined)*/
+    symbol_ptr symbol;
+
+    /*The name of the label (null terminated, kept in the arena with the st table)*/
+    const char* name;
+
+    /*The next fixup of the same symbol, in the order of the words (kept for the external symbols)*/
+    fixup_ptr nextOfSymbol;
+
+}fixup;
+
+/*A structure that holds the code and the data words with the instructions and directive counter,
+ *and the label operands of the code*/
+typedef struct wordTable * wordTable_ptr;
+typedef struct wordTable{
+
+    /*The instruction words (each in its WORD_NUM_OF_BITS low bits), the word of address ADDRESS_START+i is at index i*/
+    unsigned short* code;
+
+    /*The directive words, the data comes right after the code*/
+    unsigned short* data;
+
+    /*instruction counter*/
+    int IC;
+
+    /*directive counter*/
+    int DC;
+
+    /*The label operands of the instruction words, in the order of the words*/
+    fixup* fixups;
+    int numOfFixups;
+
+} wordTable;
+
+/*A part of a line (a token, an operand, a number...), pointed to without copying it*/
+typedef struct span{
+
+    /*The first character of the part (NULL if the part is missing)*/
+    const char* start;
+
+    /*The number of characters in the part*/
+    int length;
+
+}span;
+
+/*Macro table for macros*/
+typedef struct macro * macroPtr;
+typedef struct macro{
+
+    /*The name of the macro*/
+    char* name;
+
+    /*The lines of the macro body, captured while the definition is read*/
+    buffer_ptr body;
+
+    /*Pointer to the next macro in the same bucket*/
+    macroPtr next;
+
+}macro;
+
+/*Hash table of all macros defined in a file*/
+typedef struct macroTable * macroTable_ptr;
+typedef struct macroTable{
+
+    /*Array of buckets, each bucket is a list of macros whose names have the same hash*/
+    macroPtr* buckets;
+
+    /*The number of buckets in the table*/
+    int numOfBuckets;
+
+    /*The number of macros in the table*/
+    int count;
+
+    /*A bit for every char that a macro name starts with (a fast filter for lines that are not macros)*/
+    unsigned char firstChars[CHAR_BITMAP_SIZE];
+
+    /*A bit for every length of a macro name (lengths above 31 share the last bit)*/
+    unsigned long lengths;
+
+}macroTable;
+
+typedef struct symbol{
+
+    /*The name of the symbol*/
+    char name[MAX_LABEL_SIZE + 1];
+
+    /*The address of the symbol*/
+    int address;
+
+    /*The flags of the symbol: how it is defined and declared (SYMBOL_DEFINED/SYMBOL_EXTERNAL/SYMBOL_ENTRY/SYMBOL_DATA)*/
+    int flags;
+
+    /*The first and last fixups of the symbol, in the order of the words (for an external symbol)*/
+    fixup_ptr firstFixup;
+    fixup_ptr lastFixup;
+
+    /*Pointer to the next symbol, in the order the symbols were first defined*/
+    symbol_ptr next;
+
+    /*Pointer to the next external symbol, in the order they were defined as external*/
+    symbol_ptr nextExternal;
+
+}symbol;
+
+/*Symbol table, a hash table (open addressing) of all the symbols that also keeps their order*/
+typedef struct symbolTable * symbolTable_ptr;
+typedef struct symbolTable{
+
+    /*Array of slots, each slot is empty (NULL) or holds a symbol*/
+    symbol_ptr* slots;
+
+    /*The number of slots in the table (a power of 2)*/
+    int numOfSlots;
+
+    /*The number of symbols in the table*/
+    int count;
+
+    /*The first and last symbols, in the order the symbols were first defined*/
+    symbol_ptr head;
+    symbol_ptr tail;
+
+    /*The first and last external symbols, in the order they were defined as external*/
+    symbol_ptr externalHead;
+    symbol_ptr externalTail;
+
+    /*The arena the table and its symbols are allocated from*/
+    arena_ptr arena;
+
+}symbolTable;
+
+/*An operand of an instruction sentence*/
+typedef struct operand{
+
+    /*In case the operand is a label, the name of the label*/
+    span label;
+
+    /*In case the operand is a number or a register, represent the number or the register number*/
+    short value;
+
+    /*operand type if present (number/label/register)*/
+    unsigned char type;
+
+    /*The addressing method of the operand*/
+    unsigned char adrMethod;
+
+}operand;
+
+/*sentenceTree node (each node represent a line without errors).
+ *While the line is lexed the spans and the directive point into the line,
+ *once the line is kept they point to copies in the arena (the labels are null terminated)*/
+typedef struct sentenceTree * st_ptr;
+typedef struct sentenceTree{
+
+    /*The label defined in the row (its start is NULL if there is none)*/
+    span label;
+
+    /*The symbol of the label defined in the row (NULL if there is none)*/
+    symbol_ptr symbol;
+
+    /*Line type (instruction line/ Directive line)*/
+    unsigned char sentenceType;
+
+    /*Directive type (DATA/STRING/ENTRY/EXTERN)*/
+    unsigned char directiveType;
+
+    /*A number that represents an opcode type*/
+    unsigned char opcode;
+
+    /*The number of operands according to the opcode*/
+    unsigned char numOfOperands;
+
+    /*The operands of an instruction sentence*/
+    operand source;
+    operand dest;
+
+    /*The legal numbers of a DATA directive, or the chars of a STRING directive (without the character 0)*/
+    union {
+        int* numbers;
+        const char* str;
+    } directive;
+
+    /*The number of numbers/chars in the directive*/
+    int count;
+
+}sentenceTree;
+
+/*The st table: the st nodes of all the lines without errors (in the order of the lines) and the symbol table*/
+typedef struct stTable * stTable_ptr;
+typedef struct stTable{
+
+    /*An array of the st nodes*/
+    st_ptr sentences;
+
+    /*The number of st nodes in the array*/
+    int count;
+
+    /*The symbol table of the lines*/
+    symbolTable_ptr symbols;
+
+}stTable;
+
+
+/**
+ * Creates a new empty symbol table, the table and its symbols are freed with the arena.
+ *
+ * @param arena The arena to allocate the table from.
+ * @return A pointer to the new symbol table, or NULL if memory could not be allocated.
+ */
+symbolTable_ptr createSymbolTable(arena_ptr arena);
+
+/**
+ * Defines a label in the symbol table with the specified type.
+ * A new name gets a new symbol, otherwise the flag of the type is added to the symbol of the name.
+ *
+ * @param table The symbol table.
+ * @param name The name of the symbol.
+ * @param type The type of the definition (external/relocatable/entry).
+ * @return A pointer to the symbol of the name, or NULL if memory could not be allocated.
+ */
+symbol_ptr addSymbol(symbolTable_ptr table, const char* name, int type);
+
+/**
+ * Searches for a symbol in the symbol table by name.
+ *
+ * @param table The symbol table.
+ * @param symbolName The name of the symbol to search for.
+ * @return A pointer to the found symbol, or NULL if not found.
+ */
+symbol_ptr searchForSymbol(symbolTable_ptr table, const char* symbolName);
+
+/**
+ * Initializes a st node.
+ *
+ * @param st The st node to be initialized.
+ */
+void initializeSt(st_ptr st);
+
+/**
+ * Creates a new empty macro table.
+ *
+ * @return A pointer to the new macro table, or NULL if memory could not be allocated.
+ */
+macroTable_ptr createMacroTable(void);
+
+/**
+ * Adds a macro to the macro table (if a name is defined again, searching it still finds the first definition).
+ *
+ * @param table The macro table.
+ * @param mcr The macro to be added.
+ * @return 0 if the macro was added, -1 if memory could not be allocated.
+ */
+int addToMacroTable(macroTable_ptr table, macroPtr mcr);
+
+/**
+ * Searches for a macro in the macro table by name.
+ *
+ * @param table The macro table.
+ * @param name The name of the macro to search for.
+ * @return A pointer to the found macro, or NULL if not found.
+ */
+macroPtr searchForMacro(macroTable_ptr table, const char* name);
+
+/**
+ * Adds a line to the body of a macro, blank lines and comment lines are not kept.
+ *
+ * @param mcr The macro that is being defined.
+ * @param line The line to add.
+ * @return 0 if the line was added (or skipped), -1 if memory could not be allocated.
+ */
+int addLineToMacro(macroPtr mcr, const char* line);
+
+/**
+ * Frees the memory occupied by the macro table.
+ *
+ * @param table The macro table.
+ */
+void freeMacroTable(macroTable_ptr table);
+
+#endif /* TABLES_H */
+
@@ -0,0 +1,279 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "threadPool.h"
+#include "globals.h"
+
+/*A task that waits in the queue of the pool*/
+typedef struct task{
+
+    /*The function to run*/
+    taskFunction function;
+
+    /*The argument of the function*/
+    void* arg;
+
+}task;
+
+struct threadPool{
+
+    /*The threads of the pool*/
+    pthread_t* threads;
+
+    /*The number of threads in the pool*/
+    int numOfThreads;
+
+    /*A circular queue of the tasks that are waiting to run*/
+    task* tasks;
+
+    /*The number of tasks the queue can hold*/
+    int size;
+
+    /*The index of the first task in the queue*/
+    int first;
+
+    /*The number of tasks in the queue*/
+    int count;
+
+    /*The number of tasks that were given and are not done yet (in the queue or running)*/
+    int pending;
+
+    /*Whether the threads should stop once the queue is empty*/
+    int stop;
+
+    /*Protects all the fields above*/
+    pthread_mutex_t lock;
+
+    /*Signaled when a task is added to the queue (or the pool stops)*/
+    pthread_cond_t taskAdded;
+
+    /*Signaled when the last pending task is done*/
+    pthread_cond_t tasksDone;
+};
+
+struct boundedQueue{
+
+    /*A circular array of the items in the queue*/
+    void** items;
+
+    /*The number of items the queue can hold*/
+    int capacity;
+
+    /*The index of the first item, and the number of items*/
+    int first;
+    int count;
+
+    /*Whether no more items are added*/
+    int closed;
+
+    /*Protects all the fields above*/
+    pthread_mutex_t lock;
+
+    /*Signaled when an item is added (or the queue is closed)*/
+    pthread_cond_t notEmpty;
+
+    /*Signaled when an item is taken*/
+    pthread_cond_t notFull;
+};
+
+/**
+ * The loop of every thread of the pool: takes a task from the queue and runs it.
+ *
+ * @param arg The pool of the thread.
+ * @return NULL.
+ */
+static void* workerLoop(void* arg);
+
+threadPool_ptr createThreadPool(int numOfThreads){
+    threadPool_ptr pool;
+    int i;
+
+    if(numOfThreads < 1 || numOfThreads > MAX_THREADS)
+        return NULL;
+
+    pool = (threadPool_ptr) malloc(sizeof(struct threadPool));
+    if(pool==NULL)
+        return NULL;
+    pool->threads = (pthread_t*) malloc(numOfThreads * sizeof(pthread_t));
+    pool->tasks = (task*) malloc(TASK_QUEUE_INITIAL_SIZE * sizeof(task));
+    if(pool->threads==NULL || pool->tasks==NULL){
+        free(pool->threads);
+        free(pool->tasks);
+        free(pool);
+        return NULL;
+    }
+    pool->numOfThreads = 0;
+    pool->size = TASK_QUEUE_INITIAL_SIZE;
+    pool->first = 0;
+    pool->count = 0;
+    pool->pending = 0;
+    pool->stop = FALSE;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->taskAdded, NULL);
+    pthread_cond_init(&pool->tasksDone, NULL);
+
+    /*Starts the threads, a pool with fewer threads still works*/
+    for (i = 0; i < numOfThreads; i++) {
+        if(pthread_create(&pool->threads[i], NULL, workerLoop, pool) != 0)
+            break;
+        pool->numOfThreads++;
+    }
+    if(pool->numOfThreads == 0){
+        freeThreadPool(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+int submitTask(threadPool_ptr pool, taskFunction function, void* arg){
+    pthread_mutex_lock(&pool->lock);
+
+    /*Doubles the queue when it is full, the tasks are moved to the start of the new queue*/
+    if(pool->count == pool->size){
+        int i;
+        task* newTasks = (task*) malloc(2 * pool->size * sizeof(task));
+        if(newTasks==NULL){
+            pthread_mutex_unlock(&pool->lock);
+            return FALSE;
+        }
+        for (i = 0; i < pool->count; i++)
+            newTasks[i] = pool->tasks[(pool->first + i) % pool->size];
+        free(pool->tasks);
+        pool->tasks = newTasks;
+        pool->size *= 2;
+        pool->first = 0;
+    }
+
+    pool->tasks[(pool->first + pool->count) % pool->size].function = function;
+    pool->tasks[(pool->first + pool->count) % pool->size].arg = arg;
+    pool->count++;
+    pool->pending++;
+    pthread_cond_signal(&pool->taskAdded);
+    pthread_mutex_unlock(&pool->lock);
+    return TRUE;
+}
+
+void waitForTasks(threadPool_ptr pool){
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->tasksDone, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void freeThreadPool(threadPool_ptr pool){
+    int i;
+
+    if(pool==NULL)return;
+
+    /*Wakes all the threads so they see the stop flag*/
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = TRUE;
+    pthread_cond_broadcast(&pool->taskAdded);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->numOfThreads; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->taskAdded);
+    pthread_cond_destroy(&pool->tasksDone);
+    free(pool->threads);
+    free(pool->tasks);
+    free(pool);
+}
+
+static void* workerLoop(void* arg){
+    threadPool_ptr pool = (threadPool_ptr) arg;
+    task current;
+
+    while (1) {
+
+        /*Waits for a task, the thread ends when the pool stops and the queue is empty*/
+        pthread_mutex_lock(&pool->lock);
+        while (pool->count == 0 && pool->stop == FALSE)
+            pthread_cond_wait(&pool->taskAdded, &pool->lock);
+        if(pool->count == 0){
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        current = pool->tasks[pool->first];
+        pool->first = (pool->first + 1) % pool->size;
+        pool->count--;
+        pthread_mutex_unlock(&pool->lock);
+
+        current.function(current.arg);
+
+        /*The last pending task wakes whoever waits for the tasks*/
+        pthread_mutex_lock(&pool->lock);
+        pool->pending--;
+        if(pool->pending == 0)
+            pthread_cond_broadcast(&pool->tasksDone);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+boundedQueue_ptr createBoundedQueue(int capacity){
+    boundedQueue_ptr queue;
+
+    if(capacity < 1)
+        return NULL;
+    queue = (boundedQueue_ptr) malloc(sizeof(struct boundedQueue));
+    if(queue==NULL)
+        return NULL;
+    queue->items = (void**) malloc(capacity * sizeof(void*));
+    if(queue->items==NULL){
+        free(queue);
+        return NULL;
+    }
+    queue->capacity = capacity;
+    queue->first = 0;
+    queue->count = 0;
+    queue->closed = FALSE;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    pthread_cond_init(&queue->notFull, NULL);
+    return queue;
+}
+
+void pushToQueue(boundedQueue_ptr queue, void* item){
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->capacity)
+        pthread_cond_wait(&queue->notFull, &queue->lock);
+    queue->items[(queue->first + queue->count) % queue->capacity] = item;
+    queue->count++;
+    pthread_cond_signal(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void* popFromQueue(boundedQueue_ptr queue){
+    void* item = NULL;
+
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && queue->closed == FALSE)
+        pthread_cond_wait(&queue->notEmpty, &queue->lock);
+    if(queue->count > 0){
+        item = queue->items[queue->first];
+        queue->first = (queue->first + 1) % queue->capacity;
+        queue->count--;
+        pthread_cond_signal(&queue->notFull);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return item;
+}
+
+void closeQueue(boundedQueue_ptr queue){
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = TRUE;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void freeBoundedQueue(boundedQueue_ptr queue){
+    if(queue==NULL)return;
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->notEmpty);
+    pthread_cond_destroy(&queue->notFull);
+    free(queue->items);
+    free(queue);
+}
@@ -0,0 +1,86 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#define TASK_QUEUE_INITIAL_SIZE 16 /*The initial number of tasks the queue of a pool can hold*/
+#define MAX_THREADS 256 /*The maximum number of threads in a pool*/
+
+/*A function that is run by a thread of the pool*/
+typedef void (*taskFunction)(void* arg);
+
+/*A pool of threads that run the tasks given to it (its content is private to threadPool.c)*/
+typedef struct threadPool * threadPool_ptr;
+
+/*A queue of a fixed size that passes items from threads to threads (its content is private to threadPool.c)*/
+typedef struct boundedQueue * boundedQueue_ptr;
+
+/**
+ * Creates a pool of threads that wait for tasks.
+ *
+ * @param numOfThreads The number of threads in the pool (1 to MAX_THREADS).
+ * @return A pointer to the new pool, or NULL if it could not be created.
+ */
+threadPool_ptr createThreadPool(int numOfThreads);
+
+/**
+ * Adds a task to the queue of the pool, it is run by the first thread that is free.
+ *
+ * @param pool The pool.
+ * @param function The function to run.
+ * @param arg The argument to pass to the function.
+ * @return 0 if the task was added, -1 if memory could not be allocated.
+ */
+int submitTask(threadPool_ptr pool, taskFunction function, void* arg);
+
+/**
+ * Waits until all the tasks that were given to the pool are done.
+ *
+ * @param pool The pool.
+ */
+void waitForTasks(threadPool_ptr pool);
+
+/**
+ * Stops the threads of the pool (after the tasks in the queue are done) and frees it.
+ *
+ * @param pool The pool to free.
+ */
+void freeThreadPool(threadPool_ptr pool);
+
+/**
+ * Creates a queue that holds up to a fixed number of items.
+ *
+ * @param capacity The number of items the queue can hold (at least 1).
+ * @return A pointer to the new queue, or NULL if memory could not be allocated.
+ */
+boundedQueue_ptr createBoundedQueue(int capacity);
+
+/**
+ * Adds an item to the end of the queue, waiting while the queue is full.
+ *
+ * @param queue The queue (not closed).
+ * @param item The item to add (not NULL).
+ */
+void pushToQueue(boundedQueue_ptr queue, void* item);
+
+/**
+ * Takes the item at the start of the queue, waiting while the queue is empty.
+ *
+ * @param queue The queue.
+ * @return The item, or NULL if the queue is empty and closed.
+ */
+void* popFromQueue(boundedQueue_ptr queue);
+
+/**
+ * Closes the queue: no more items are added, and once it is empty popFromQueue returns NULL.
+ *
+ * @param queue The queue.
+ */
+void closeQueue(boundedQueue_ptr queue);
+
+/**
+ * Frees a queue (no thread may use it anymore).
+ *
+ * @param queue The queue to free.
+ */
+void freeBoundedQueue(boundedQueue_ptr queue);
+
+#endif /* THREAD_POOL_H */
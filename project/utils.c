@@ -1,229 +1,155 @@
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include "utils.h"
-#include "globals.h"
-
-
-int isRegisterLabel(const char* label) {
-    /*Returns a number between 0 and 7 according to the
- * register in the label, otherwise none of them will return 8*/
-    if(label==NULL)
-        return non_reg;
-    if(strcmp(label,"r0")==0)
-        return r0;
-    if(strcmp(label,"r1")==0)
-        return r1;
-    if(strcmp(label,"r2")==0)
-        return r2;
-    if(strcmp(label,"r3")==0)
-        return r3;
-    if(strcmp(label,"r4")==0)
-        return r4;
-    if(strcmp(label,"r5")==0)
-        return r5;
-    if(strcmp(label,"r6")==0)
-        return r6;
-    if(strcmp(label,"r7")==0)
-        return r7;
-    else
-        return non_reg;
-}
-
-int isInstructionLabel(const char* label) {
-    /*Returns a number between 0 and 15 according to the
-     * opcode in the label, otherwise none of them will return 16*/
-    if (label == NULL)
-        return non_op;
-    if (strcmp(label, "mov") == 0)
-        return mov;
-    if (strcmp(label, "cmp") == 0)
-        return cmp;
-    if (strcmp(label, "add") == 0)
-        return add;
-    if (strcmp(label, "sub") == 0)
-        return sub;
-    if (strcmp(label, "not") == 0)
-        return not;
-    if (strcmp(label, "clr") == 0)
-        return clr;
-    if (strcmp(label, "lea") == 0)
-        return lea;
-    if (strcmp(label, "inc") == 0)
-        return inc;
-    if (strcmp(label, "dec") == 0)
-        return dec;
-    if (strcmp(label, "jmp") == 0)
-        return jmp;
-    if (strcmp(label, "bne") == 0)
-        return bne;
-    if (strcmp(label, "red") == 0)
-        return red;
-    if (strcmp(label, "prn") == 0)
-        return prn;
-    if (strcmp(label, "jsr") == 0)
-        return jsr;
-    if (strcmp(label, "rts") == 0)
-        return rts;
-    if (strcmp(label, "stop") == 0)
-        return stop;
-    return non_op;
-}
-
-int isDirectiveLabel(const char* label) {
-    /*Returns a number between 0 and 3 according to the directive
-     * in the label, otherwise none of them will return 4*/
-    if(label==NULL)
-        return non_dir;
-    if(strcmp(label,".data")==0)
-        return DATA;
-    if(strcmp(label,".string")==0)
-        return STRING;
-    if(strcmp(label,".entry")==0)
-        return ENTRY;
-    if(strcmp(label,".extern")==0)
-        return EXTERN;
-    else
-        return non_dir;
-}
-
-int skipWhiteChars(const char* line,int* index){
-    /*Skips white characters and returns the number of times it was skipped*/
-    int whiteCounts = 0;
-    while ((line[(*index)]==SPACE_BAR || line[(*index)]==TAB) && line[(*index)]!=END_OF_LINE){
-        (*index)++;
-        whiteCounts++;
-    }
-    return whiteCounts;
-}
-
-int findIndexFromLine(const char* line,char ch){
-    /*Returns the index at which the character is in the line*/
-    int index = 0;
-    while (line[index]!=ch) {
-        if (line[index] == END_OF_LINE)
-            return 0;
-        index++;
-    }
-    return index;
-}
-
-int fileExists(const char* filename) {
-    /*Gets a file name and checks if it exists*/
-    FILE* file = fopen(filename, "r");
-    if (file != NULL) {
-        fclose(file);
-        return TRUE;
-    }
-    return FALSE;
-}
-
-char* setOutputFile(const char* file,char* ext){
-    /*Gets a name and a suffix and creates a new string of the name with the suffix.
-     * For example, the name example and the suffix .am will be returned example.am)*/
-
-    const char* fileName = file;
-    const char* extension = ext;
-    unsigned int fileNameLen = strlen(fileName);
-    unsigned int extensionLen = strlen(extension);
-    char* fileWithExtension = (char*) malloc(fileNameLen + extensionLen + 1);
-
-    MALLOC_CHECK(fileWithExtension)
-
-    strcpy(fileWithExtension, fileName);
-    strcat(fileWithExtension, extension);
-
-    return fileWithExtension;
-}
-
-char base64DecodeChar(char c) {
-    /*Gets a number that represents a character and returns the number in base64*/
-    if (c >= 0 && c <= 25)
-        return c + 'A';
-    else if (c >= 26 && c <= 51)
-        return c - 26 + 'a';
-    else if (c >= 52 && c <= 61)
-        return c - 52 + '0';
-    else if (c == 62)
-        return '+';
-    else if (c == 63)
-        return '/';
-    else
-        return '\0';
-}
-
-int binaryToDecimal(const int binArray[]) {
-    /*Receives an array representing a binary number and converts
-     * its 6 cells (depending on what was sent) to the
-     * numerical representation of the binary*/
-    int result = 0;
-    int i;
-    for (i = 0; i < 6; i++) {
-        result = (result << 1) | binArray[i];
-    }
-    return result;
-}
-void printBase64ToFile(char c1,char c2, FILE* obFile){
-    /*Prints to a file 2 characters side by side and then drops a line*/
-    fprintf(obFile,"%c",c1);
-    fprintf(obFile,"%c",c2);
-    fprintf(obFile,"\n");
-}
-
-void convertToCharsBase64(int binCode[],FILE* obFile) {
-    /*Arrays that represent 2 parts of a 12-bit binary number*/
-    int firstBinArr[6] = {0};
-    int secondBinArr[6] = {0};
-
-    int index = 0, i;
-    char firstChar, secondChar,firstBinToDecimal,secondBinToDecimal;
-
-    /*Divides 12-bit binary number into 2 numbers of a 6-bit*/
-    for (i = 0; i < 6; i++) {
-        firstBinArr[index] = binCode[11 - i];
-        secondBinArr[index] = binCode[5 - i];
-        index++;
-    }
-
-    /*Converts the binary numbers to decimal numbers*/
-    firstBinToDecimal = binaryToDecimal(firstBinArr);
-    secondBinToDecimal = binaryToDecimal(secondBinArr);
-
-    /*Converts the decimal numbers to base64 characters*/
-    firstChar = base64DecodeChar(firstBinToDecimal);
-    secondChar = base64DecodeChar(secondBinToDecimal);
-
-    /*Prints the received characters to the object file*/
-    printBase64ToFile(firstChar,secondChar,obFile);
-}
-
-void decimalToBinary(int arr[],int number,int numberOfBits) {
-    /*covert the number in a given number of bits, and enter
-     * him into the binCode array*/
-    int i;
-    int mask = 1 << (numberOfBits - 1);
-
-    for (i = numberOfBits - 1; i >= 0; i--) {
-        arr[i] = (number & mask) ? 1 : 0;
-        mask >>= 1;
-    }
-}
-
-void charToBinary(char ch, int charArr[]) {
-    /*Converts a character's ascii code to binary and puts it into an array*/
-    int i;
-    for (i = 0; i < 8; i++)
-        charArr[i] = (ch >> i) & 1;
-}
-
-void resetInsArr(int sourceAdrArr[],int destAdrArr[],int opcodeArr[],int areArr[],int numInsArr[],int srcReg[],int desReg[]){
-    /*reset every Instruction array  to 0*/
-    memset(sourceAdrArr, 0, 3*sizeof(int));
-    memset(destAdrArr, 0, 3*sizeof(int));
-    memset(opcodeArr, 0, 4*sizeof(int));
-    memset(areArr, 0, 2*sizeof(int));
-    memset(numInsArr, 0, 10*sizeof(int));
-    memset(srcReg, 0, 5*sizeof(int));
-    memset(desReg, 0, 5*sizeof(int));
-}
-
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "utils.h"
+#include "globals.h"
+
+/*A keyword of the language and what it stands for*/
+typedef struct keyword{
+
+    /*The name of the keyword*/
+    const char* name;
+
+    /*The type of the keyword (opcode/directive/register)*/
+    int type;
+
+    /*The opcode, directive or register number of the keyword*/
+    int value;
+
+}keyword;
+
+/*Hash of the keywords of the language: first char + 12 * second char + 21 * last char + length,
+ *modulo the table size. A keyword is put in the slot of its hash, or in the next free one if it is taken
+ *(none of the keywords of today shares a slot, so a keyword is confirmed by a single compare)*/
+#define KEYWORD_TABLE_SIZE 64
+#define MIN_KEYWORD_LENGTH 2
+#define MAX_KEYWORD_LENGTH 7
+#define KEYWORD_HASH(token, length) \
+    (((unsigned char)(token)[0] + 12 * (unsigned char)(token)[1] + \
+    21 * (unsigned char)(token)[(length) - 1] + (length)) % KEYWORD_TABLE_SIZE)
+
+#define OPCODE_KEYWORD(name, numOfOperands, sourceTypes, destTypes) {#name, opcode_keyword, name},
+
+/*The keywords of the language, the instruction names come from the list of the instructions*/
+static const keyword keywords[] = {
+    INSTRUCTION_LIST(OPCODE_KEYWORD)
+    {".data", directive_keyword, DATA},
+    {".string", directive_keyword, STRING},
+    {".entry", directive_keyword, ENTRY},
+    {".extern", directive_keyword, EXTERN},
+    {"r0", register_keyword, r0},
+    {"r1", register_keyword, r1},
+    {"r2", register_keyword, r2},
+    {"r3", register_keyword, r3},
+    {"r4", register_keyword, r4},
+    {"r5", register_keyword, r5},
+    {"r6", register_keyword, r6},
+    {"r7", register_keyword, r7}
+};
+
+#define NUM_OF_KEYWORDS (sizeof(keywords) / sizeof(keywords[0]))
+
+/*The table must keep a free slot, so that looking up a token that is not a keyword ends*/
+typedef char keywordTableHasFreeSlot[(NUM_OF_KEYWORDS < KEYWORD_TABLE_SIZE) ? 1 : -1];
+
+/*The keywords by their hash (built when a keyword is first looked up)*/
+static keyword keywordTable[KEYWORD_TABLE_SIZE];
+static pthread_once_t keywordTableOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Puts every keyword in the slot of its hash in the keyword table (or in the next free one).
+ */
+static void createKeywordTable(void);
+
+/*The base64 character of every 6-bit number*/
+static const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#define INSTRUCTION_INFO(name, numOfOperands, sourceTypes, destTypes) \
+    {numOfOperands, sourceTypes, destTypes, ENCODE_ARE(ARE_ABSOLUTE) | ENCODE_OPCODE(name)},
+
+/*The descriptors of the instructions, indexed by opcode*/
+static const instructionInfo instructionTable[non_op] = {
+    INSTRUCTION_LIST(INSTRUCTION_INFO)
+};
+
+const instructionInfo* getInstructionInfo(int opcode){
+    if(opcode < 0 || opcode >= non_op)
+        return NULL;
+    return &instructionTable[opcode];
+}
+
+int classifyKeyword(const char* token, int length, int* value) {
+    int hash;
+    const keyword* entry;
+
+    /*Keywords are 2 to 7 characters long, anything else is not a keyword*/
+    if (token == NULL || length < MIN_KEYWORD_LENGTH || length > MAX_KEYWORD_LENGTH)
+        return non_keyword;
+
+    /*A keyword is in the slot of its hash or after it, the first free slot ends the search*/
+    pthread_once(&keywordTableOnce, createKeywordTable);
+    for (hash = KEYWORD_HASH(token, length); keywordTable[hash].name != NULL; hash = (hash + 1) % KEYWORD_TABLE_SIZE) {
+        entry = &keywordTable[hash];
+        if (strncmp(entry->name, token, length) == 0 && entry->name[length] == NULL_TERM) {
+            if (value != NULL)
+                *value = entry->value;
+            return entry->type;
+        }
+    }
+    return non_keyword;
+}
+
+static void createKeywordTable(void){
+    int i, hash;
+
+    for (i = 0; i < (int) NUM_OF_KEYWORDS; i++) {
+        hash = KEYWORD_HASH(keywords[i].name, (int) strlen(keywords[i].name));
+        while (keywordTable[hash].name != NULL)
+            hash = (hash + 1) % KEYWORD_TABLE_SIZE;
+        keywordTable[hash] = keywords[i];
+    }
+}
+
+unsigned long hashString(const char* str){
+    /*Multiplies the hash by 33 and adds the next character*/
+    unsigned long hash = 5381;
+    while (*str != NULL_TERM){
+        hash = hash * 33 + (unsigned char)(*str);
+        str++;
+    }
+    return hash;
+}
+
+char* setOutputFile(const char* file,char* ext){
+    /*Gets a name and a suffix and creates a new string of the name with the suffix.
+     * For example, the name example and the suffix .am will be returned example.am)*/
+
+    const char* fileName = file;
+    const char* extension = ext;
+    unsigned int fileNameLen = strlen(fileName);
+    unsigned int extensionLen = strlen(extension);
+    char* fileWithExtension = (char*) malloc(fileNameLen + extensionLen + 1);
+
+    MALLOC_CHECK(fileWithExtension)
+
+    strcpy(fileWithExtension, fileName);
+    strcat(fileWithExtension, extension);
+
+    return fileWithExtension;
+}
+
+long encodeWordsBase64(const unsigned short* words, int numOfWords, char* text) {
+    char* next = text;
+    int i;
+
+    /*Divides every 12-bit word into 2 numbers of 6 bits and looks up their base64 characters*/
+    for (i = 0; i < numOfWords; i++) {
+        next[0] = base64Alphabet[(words[i] >> 6) & 0x3F];
+        next[1] = base64Alphabet[words[i] & 0x3F];
+        next[2] = END_OF_LINE;
+        next += BASE64_WORD_LENGTH;
+    }
+    return (long)(next - text);
+}